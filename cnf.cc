@@ -17,7 +17,7 @@
 #include "cnf.hh"
 
 // Code
-cnf::cnf(const std::initializer_list<clause>& clauses): varnumber {0}, clauses {} {
+cnf::cnf(const std::initializer_list<clause>& clauses): varnumber {0}, literals {}, offsets {0}, mark {0} {
   for (auto& cla : clauses) {
     add_clause(cla);    
   }
@@ -26,7 +26,9 @@ cnf::cnf(const std::initializer_list<clause>& clauses): varnumber {0}, clauses {
 bool cnf::operator==(const cnf& other) const {
   if (variables_number()!= other.variables_number()) return false;
 
-  return clauses==other.clauses;
+  // same sequence of clauses iff same clause boundaries and same
+  // literals
+  return offsets==other.offsets && literals==other.literals;
 }
 
 
@@ -29,11 +29,22 @@
   `literals`. Notice that `variable` is a signed type and `literal` is
   just an alias for that.
     
-  Each clause is represented as a standard C++ vector of literals and
-  the CNF as a standard C++ list of clauses.
-
-  The `cnf` object can indeed be iterated with read/only access as a
-  list of vector<literal>, each representing a clause.
+  A clause is represented as a standard C++ vector of literals when
+  it is built by the user, but the CNF does not store the clauses as
+  separate vectors. All literals of all clauses are kept one after
+  the other in a single array, and a second array keeps the offset
+  of each clause. Adding a clause just appends its literals.
+
+  The `cnf` object can be iterated with read/only access as a
+  sequence of `clause_view` objects, each representing a clause. A
+  `clause_view` is a pair of pointers to the literals of the clause,
+  which behaves like a read only vector<literal> (i.e. it has
+  `size()`, `begin()`, `end()` and `operator[]`). Clauses can also be
+  accessed by position, with `F[i]`.
+
+  A `clause_view` does not own the literals, hence it is valid only
+  as long as the object it refers to is alive and unchanged. In
+  particular adding clauses to a `cnf` invalidates the views on it.
 
   N.B.: literals and clauses order matter. Comparison by value takes
   order in consideration to decide if two `cnf` objects are the same.
@@ -74,17 +85,57 @@
   2 . literal, variable, clause types are just aliases to library
   types, so the type system do not distinguish between the alias and
   the original type.
+
+  3 . a formula with m clauses and L literals in total occupies
+  4L + 8m bytes, in two memory blocks.
+
+  Incremental use:
+
+  A formula which grows by batches of clauses has a watermark, which
+  tells apart the clauses already processed (e.g. transformed by
+  `kcnf_incremental`, see `cnftools.hh`) from the new ones.
+
+     F.set_watermark();              // all clauses so far are processed
+     F.add_clause({-1,2,3});
+     F.watermark();                  // F[F.watermark()] is the new clause
+
+  The watermark is 0 for a new formula, it is copied with the formula,
+  and it is ignored when formulas are compared.
+
+  Packed literals:
+
+  Code which keeps a value for each literal (occurrence lists,
+  assignments, ...) can use the `packed_literal` type, where the
+  literals of variable v are the unsigned values 2(v-1) (positive)
+  and 2(v-1)+1 (negative). Then `index()` is a position in a flat
+  array of size 2n, the negation is `~lit` and the variable is
+  `index()/2`, all without branching on the sign.
+
+     packed_literal p {-3};          // from dimacs
+     p.index();                      // 5
+     (~p).index();                   // 4
+     literal l {p.dimacs()};         // -3 again
+
+  The conversions are constexpr and branch free, and a packed literal
+  is not implicitly converted to or from an int, so the two encodings
+  cannot be mixed by mistake. Formulas are stored with dimacs
+  literals; the dimacs reader and writer also accept clauses of packed
+  literals.
   
 */
 
 #ifndef _CNF_HH_
 #define _CNF_HH_
 
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <vector>
-#include <list>
 #include <stdexcept>
 #include <algorithm>
 #include <initializer_list>
+#include <iosfwd>
 
 
 // Code
@@ -100,58 +151,203 @@ constexpr literal toliteral(const variable& v,bool sign) {
 }
 
 
+class packed_literal {
+
+  private:
+
+    uint32_t code;
+
+    struct from_code {};
+    constexpr packed_literal(uint32_t code, from_code): code{code} {}
+
+    // all ones if x<0, zero otherwise
+    static constexpr uint32_t sign_mask(literal x) {
+      return static_cast<uint32_t>(x >> 31);
+    }
+
+  public:
+
+    constexpr packed_literal(): code{0} {}
+
+    // from a non zero dimacs literal
+    constexpr explicit packed_literal(literal lit):
+      code{2*((static_cast<uint32_t>(lit) ^ sign_mask(lit)) - sign_mask(lit) - 1) + (sign_mask(lit) & 1)} {}
+
+    constexpr packed_literal(variable v,bool sign):
+      code{2*(static_cast<uint32_t>(v)-1) + (sign ? 0 : 1)} {}
+
+    static constexpr packed_literal from_index(uint32_t index) {
+      return {index,from_code{}};
+    }
+
+    constexpr uint32_t index()    const { return code; }
+    constexpr variable var()      const { return static_cast<variable>(code/2+1); }
+    constexpr bool     negative() const { return (code & 1)!=0; }
+
+    // the dimacs literal
+    constexpr literal dimacs() const {
+      return (static_cast<literal>(code/2+1) ^ -static_cast<literal>(code & 1))
+             + static_cast<literal>(code & 1);
+    }
+
+    constexpr packed_literal operator~() const { return {code ^ 1,from_code{}}; }
+
+    constexpr bool operator==(packed_literal other) const { return code==other.code; }
+    constexpr bool operator!=(packed_literal other) const { return code!=other.code; }
+    constexpr bool operator< (packed_literal other) const { return code< other.code; }
+};
+
+using packed_clause = std::vector<packed_literal>;
+
+constexpr packed_literal topacked(const variable& v,bool sign) {
+  return packed_literal{v,sign};
+}
+
+
+// Read only view of a sequence of literals stored elsewhere.
+class clause_view {
+
+  private:
+
+    const literal* first;
+    const literal* last;
+
+  public:
+
+    using size_type      = size_t;
+    using value_type     = literal;
+    using const_iterator = const literal*;
+    using iterator       = const literal*;
+
+    clause_view(): first{nullptr}, last{nullptr} {}
+    clause_view(const literal* first, const literal* last): first{first}, last{last} {}
+    clause_view(const clause& c): first{c.data()}, last{c.data()+c.size()} {}
+    clause_view(const std::initializer_list<literal>& c): first{c.begin()}, last{c.end()} {}
+
+    const_iterator begin() const { return first; }
+    const_iterator end()   const { return last; }
+
+    size_type size()  const { return last-first; }
+    bool      empty() const { return first==last; }
+
+    literal operator[](size_type i) const { return first[i]; }
+
+    bool operator==(const clause_view& other) const {
+      return size()==other.size() && std::equal(first,last,other.first);
+    }
+    bool operator!=(const clause_view& other) const { return !((*this)==other);};
+};
+
+
 class cnf {
 
   private:
 
     variable varnumber;
-    std::list<clause> clauses;
-  
+    std::vector<literal> literals;   // all clauses, one after the other
+    std::vector<size_t>  offsets;    // clause i is [offsets[i],offsets[i+1])
+    size_t               mark;       // clauses before the watermark
+
+    // binary caches copy the storage directly (see `cnf_cache.hh`)
+    friend void write_cnf_cache(std::ostream& out,const cnf& F);
+    friend cnf  read_cnf_cache(const char* begin,const char* end);
+
   public:
 
-    using size_type = typename std::list<clause>::size_type;
-    using clause_iterator = typename std::list<clause>::const_iterator;
-    
-    clause_iterator begin() const { return clauses.begin(); }
-    clause_iterator end()   const { return clauses.end(); }
-  
-    
+    using size_type = size_t;
+
+    // Random access iterator over the clauses, which are returned as
+    // `clause_view` objects.
+    class clause_iterator {
+
+      private:
+
+        const literal* base;
+        const size_t*  offset;
+
+      public:
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = clause_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const clause_view*;
+        using reference         = clause_view;
+
+        clause_iterator(const literal* base, const size_t* offset): base{base}, offset{offset} {}
+
+        clause_view operator*() const { return {base+offset[0],base+offset[1]}; }
+        clause_view operator[](difference_type i) const { return *((*this)+i); }
+
+        clause_iterator& operator++() { ++offset; return *this; }
+        clause_iterator& operator--() { --offset; return *this; }
+        clause_iterator  operator++(int) { auto old=*this; ++offset; return old; }
+        clause_iterator  operator--(int) { auto old=*this; --offset; return old; }
+        clause_iterator& operator+=(difference_type i) { offset+=i; return *this; }
+        clause_iterator& operator-=(difference_type i) { offset-=i; return *this; }
+        clause_iterator  operator+(difference_type i) const { return {base,offset+i}; }
+        clause_iterator  operator-(difference_type i) const { return {base,offset-i}; }
+        difference_type  operator-(const clause_iterator& other) const { return offset-other.offset; }
+
+        bool operator==(const clause_iterator& other) const { return offset==other.offset; }
+        bool operator!=(const clause_iterator& other) const { return offset!=other.offset; }
+        bool operator< (const clause_iterator& other) const { return offset< other.offset; }
+    };
+
+    clause_iterator begin() const { return {literals.data(),offsets.data()}; }
+    clause_iterator end()   const { return {literals.data(),offsets.data()+size()}; }
+
+    clause_view operator[](size_type i) const {
+      return {literals.data()+offsets[i],literals.data()+offsets[i+1]};
+    }
+
     cnf(variable nvars=0):
       varnumber {nvars},
-      clauses{} {
+      literals{},
+      offsets{0},
+      mark{0} {
         if (nvars<0)
           throw std::invalid_argument{"Number of variable must be non negative."};}
-    
+
     cnf& operator=(cnf&& rvalue) {
-      varnumber    = rvalue.varnumber;
-      clauses = std::move(rvalue.clauses);
+      varnumber = rvalue.varnumber;
+      literals  = std::move(rvalue.literals);
+      offsets   = std::move(rvalue.offsets);
+      mark      = rvalue.mark;
+      rvalue.offsets.assign(1,0);
+      rvalue.mark = 0;
       return *this;
     }
 
-    cnf& operator=(cnf&  value) {
+    cnf& operator=(const cnf& value) {
       varnumber = value.varnumber;
-      clauses = value.clauses;
+      literals  = value.literals;
+      offsets   = value.offsets;
+      mark      = value.mark;
       return *this;
     }
-    
+
     cnf(cnf&& rvalue):
       varnumber{rvalue.varnumber},
-      clauses {std::move(rvalue.clauses)}
-    { }
-    
-    cnf(cnf&  value):
+      literals {std::move(rvalue.literals)},
+      offsets  {std::move(rvalue.offsets)},
+      mark     {rvalue.mark}
+    { rvalue.offsets.assign(1,0); rvalue.mark = 0; }
+
+    cnf(const cnf& value):
       varnumber{value.varnumber},
-      clauses  {value.clauses}
+      literals {value.literals},
+      offsets  {value.offsets},
+      mark     {value.mark}
     { }
-    
+
     cnf(const std::initializer_list<clause>& clauses);
-  
+
     variable variables_number() const {return varnumber;}
-    
+
     void update_variables(variable atleast) {
       varnumber = std::max(atleast,varnumber);
     }
-  
+
     variable add_variable() {
       return ++varnumber;
     }
@@ -160,7 +356,7 @@ class cnf {
     // before any change is done to the cnf object. If clause is
     // consistent and mentions new variables, the number of variables
     // is raised in the cnf object.
-    void add_clause(const clause& c) {
+    void add_clause(clause_view c) {
 
       variable newvars {0};
 
@@ -170,10 +366,62 @@ class cnf {
         newvars = std::max(abs(lit),newvars);
       }
       update_variables(newvars);
-      clauses.push_back(c);
+
+      // the clause may be stored in this very object
+      if (!literals.empty() &&
+          c.begin() >= literals.data() && c.begin() < literals.data()+literals.size()) {
+        size_t from = c.begin() - literals.data();
+        size_t to   = from + c.size();
+        literals.reserve(literals.size()+c.size());
+        for(size_t i=from; i<to; ++i) literals.push_back(literals[i]);
+      } else {
+        literals.insert(literals.end(),c.begin(),c.end());
+      }
+      offsets.push_back(literals.size());
     }
-    
-    size_type size() const { return clauses.size(); }
+
+    // Append the first `count` clauses of `other` (all of them by
+    // default). The number of variables is raised to the one of
+    // `other`.
+    void append(const cnf& other,size_type count=-1) {
+      if (&other==this) {
+        append(cnf{other},count);
+        return;
+      }
+      count = std::min(count,other.size());
+      size_t base = literals.size();
+      literals.insert(literals.end(),
+                      other.literals.begin(),
+                      other.literals.begin()+other.offsets[count]);
+      offsets.reserve(offsets.size()+count);
+      for(size_type i=1; i<=count; ++i) offsets.push_back(base+other.offsets[i]);
+      update_variables(other.varnumber);
+    }
+
+    // Keep only the first `m` clauses.
+    void truncate(size_type m) {
+      if (m>=size()) return;
+      offsets.resize(m+1);
+      literals.resize(offsets[m]);
+      mark = std::min(mark,m);
+    }
+
+    // The watermark separates the clauses which have already been
+    // processed from the ones added afterwards. It is a position in
+    // the sequence of clauses, moved to the end by default.
+    size_type watermark() const { return mark; }
+    void set_watermark(size_type m=-1) { mark = std::min(m,size()); }
+
+    // Make room for `m` more clauses with `L` more literals in total.
+    void reserve(size_type m, size_type L) {
+      offsets.reserve(offsets.size()+m);
+      literals.reserve(literals.size()+L);
+    }
+
+    size_type size() const { return offsets.size()-1; }
+
+    // total number of literals occurrences in the formula
+    size_type literals_number() const { return literals.size(); }
 
     bool operator==(const cnf& other) const;
     bool operator!=(const cnf& other) const { return !((*this)==other);};
@@ -28,11 +28,15 @@
 
 // Preamble
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <string>
+#include <system_error>
 
 #include "cnftools.hh"
+#include "parallel.hh"
 
 using std::cin;
 using std::cout;
@@ -44,8 +48,10 @@ using std::string;
 
 
 string documentation = ""
-"  Input file is read on STANDARD INPUT and output file is written  \n"
-"  on the STANDARD OUTPUT.\n\n" 
+"  Input file is read on STANDARD INPUT, or from the file given with \n"
+"  option -i, and output file is written on the STANDARD OUTPUT.\n"
+"  The input is either a dimacs file or a binary cnf file saved with \n"
+"  option -c, possibly compressed with gzip, xz or zstd.\n\n"
 "  Tool to read dimacs cnf formula in input and then output a k-CNF \n"
 "  version of it.                                                   \n" 
 "                                                                   \n" 
@@ -66,38 +72,230 @@ string documentation = ""
 "  variables.                                                       \n";
 
 
+string extension_documentation = ""
+"  Option -x writes a line for each step which removes variables: \n"
+"                                                                 \n"
+"    v l1 l2 ... 0     literals set to true by -u;                \n"
+"    q v r 0           variable v replaced by -q: give v the value\n"
+"                      of the literal r;                          \n"
+"    e p l1 ... 0      clause removed by -e: if no literal li is  \n"
+"                      true, set p to true.                       \n"
+"                                                                 \n"
+"  A model of the output, with the variables of the input (i.e.   \n"
+"  translated back with the map of -m), is extended to a model of \n"
+"  the input by reading the file from the last line to the first. \n"
+"  Variables which occur nowhere can have any value.              \n";
+
+
 void usage(std::ostream &err,string programname) {
-  err<<"Usage: "<<programname<<" [-k]"<<endl<<endl;
+  err<<"Usage: "<<programname<<" [-k] [-i <file> [-s] [-j <threads>]] [-o <file>] [-c <file>] [-u] [-q] [-p] [-b] [-e] [-r <order> [-m <file>]] [-x <file>] [-t <split>] [-f]"<<endl<<endl;
   err<<"   -k  the width of the output CNF. It is an integer >2 (default k=3)."<<endl;
+  err<<"   -t  how wide clauses are split: \"chain\" of extension variables"<<endl;
+  err<<"       (default) or balanced \"tree\", which has logarithmic depth."<<endl;
+  err<<"   -f  tree split, where groups of literals which occur in several"<<endl;
+  err<<"       clauses share their extension variables (not with -s or -t)."<<endl;
+  err<<"   -i  read the formula from <file> instead of the standard input."<<endl;
+  err<<"   -s  streaming mode: the input file is read twice, and formulas"<<endl;
+  err<<"       are never stored in memory."<<endl;
+  err<<"   -j  number of threads used to parse the input file and to"<<endl;
+  err<<"       transform it (0 means one per core, default 1)."<<endl;
+  err<<"   -o  write the output formula to <file> instead of the standard"<<endl;
+  err<<"       output. It is compressed if <file> ends with .gz, .xz or .zst."<<endl;
+  err<<"   -c  save the input formula to <file> in binary format, which is"<<endl;
+  err<<"       much faster to read than dimacs (not with -s)."<<endl;
+  err<<"   -u  propagate the unit clauses and remove the pure literals"<<endl;
+  err<<"       before any other step. If the propagation finds a conflict"<<endl;
+  err<<"       the output is just the empty clause (not with -s)."<<endl;
+  err<<"   -q  replace equivalent literals, given by the binary clauses,"<<endl;
+  err<<"       with a single one, after -u if given. If a literal is"<<endl;
+  err<<"       equivalent to its negation the output is just the empty"<<endl;
+  err<<"       clause (not with -s)."<<endl;
+  err<<"   -p  simplify the formula before the transformation: remove"<<endl;
+  err<<"       repeated literals, tautologies and repeated clauses"<<endl;
+  err<<"       (not with -s)."<<endl;
+  err<<"   -b  as -p, then also remove subsumed clauses and strengthen"<<endl;
+  err<<"       clauses by self-subsuming resolution (not with -s)."<<endl;
+  err<<"   -e  eliminate variables by resolution when the formula does"<<endl;
+  err<<"       not grow, after -p or -b if given. If a resolvent is empty"<<endl;
+  err<<"       the output is just the empty clause (not with -s)."<<endl;
+  err<<"   -r  number the variables which occur from 1, after the other"<<endl;
+  err<<"       steps: in their \"compact\" order, in \"bfs\" order, or in"<<endl;
+  err<<"       reverse Cuthill-McKee order \"rcm\" (not with -s)."<<endl;
+  err<<"   -m  write to <file> the line \"j v\" for each variable j of the"<<endl;
+  err<<"       renumbered formula, which is v in the input (with -r)."<<endl;
+  err<<"   -x  write to <file> what is needed to extend a model of the"<<endl;
+  err<<"       simplified formula to a model of the input (see below)."<<endl;
   err<<endl;
+  err<<extension_documentation<<endl;
   err<<documentation<<endl;
 }
 
 
+// Terminate the output file, if any.
+void close_output(std::unique_ptr<compressed_ofstream>& output) {
+  if (!output) return;
+  try {
+    output->close();
+  } catch(const std::exception& e) {
+    cerr<<"Cannot write the output file: "<<e.what()<<endl;
+    exit(-1);
+  }
+}
+
+
+// The preprocessing has found that the formula is unsatisfiable: `F`
+// is the empty clause, and it is the whole output.
+void unsatisfiable(std::ostream& out,std::unique_ptr<compressed_ofstream>& output,
+                   const cnf& F,const string& reason) {
+  cerr<<reason<<": the formula is unsatisfiable."<<endl;
+  out<<F;
+  close_output(output);
+  exit(0);
+}
+
                                                                                  
 // Read clauses from input and reprints them
 int main(int argc, char *argv[])
 {
 
   size_t target_width {3};
+  string input_file {};
+  string cache_file {};
+  string output_file {};
+  bool   streaming {false};
+  bool   preprocess {false};
+  bool   subsumption {false};
+  bool   elimination {false};
+  bool   propagation {false};
+  bool   equivalences {false};
+  bool   renumbering {false};
+  variable_order order {variable_order::compact};
+  string map_file {};
+  string extension_file {};
+  split_strategy strategy {split_strategy::chain};
+  bool   strategy_given {false};
+  bool   factoring {false};
+  unsigned int threads {1};
 
   // process command line options
   vector<string> cmdline(argc);
   copy(argv,argv+argc,cmdline.begin());
-  auto arg = cmdline.cbegin();
-  
-  // check if the first option is a width specification
-  if (cmdline.size()>2) {
-    usage(cerr,cmdline[0]);
-    exit(-1);
-  }
-  
-  arg++;
-  if (arg != cmdline.cend() && (*arg)[0]=='-') {
+
+  for (auto arg = cmdline.cbegin()+1; arg != cmdline.cend(); ++arg) {
+
+    // input file
+    if (*arg=="-i" && arg+1 != cmdline.cend()) {
+      input_file = *(++arg);
+      continue;
+    }
+
+    // output file
+    if (*arg=="-o" && arg+1 != cmdline.cend()) {
+      output_file = *(++arg);
+      continue;
+    }
+
+    // binary copy of the input
+    if (*arg=="-c" && arg+1 != cmdline.cend()) {
+      cache_file = *(++arg);
+      continue;
+    }
+
+    if (*arg=="-s") {
+      streaming = true;
+      continue;
+    }
+
+    if (*arg=="-p") {
+      preprocess = true;
+      continue;
+    }
+
+    // splitting strategy
+    if (*arg=="-t" && arg+1 != cmdline.cend()) {
+      ++arg;
+      if (*arg=="chain")
+        strategy = split_strategy::chain;
+      else if (*arg=="tree")
+        strategy = split_strategy::tree;
+      else {
+        usage(cerr,cmdline[0]);
+        exit(-1);
+      }
+      strategy_given = true;
+      continue;
+    }
+
+    // renumbering of the variables
+    if (*arg=="-r" && arg+1 != cmdline.cend()) {
+      ++arg;
+      if (*arg=="compact")
+        order = variable_order::compact;
+      else if (*arg=="bfs")
+        order = variable_order::bfs;
+      else if (*arg=="rcm")
+        order = variable_order::reverse_cuthill_mckee;
+      else {
+        usage(cerr,cmdline[0]);
+        exit(-1);
+      }
+      renumbering = true;
+      continue;
+    }
+
+    if (*arg=="-m" && arg+1 != cmdline.cend()) {
+      map_file = *(++arg);
+      continue;
+    }
+
+    // model extension
+    if (*arg=="-x" && arg+1 != cmdline.cend()) {
+      extension_file = *(++arg);
+      continue;
+    }
+
+    if (*arg=="-f") {
+      factoring = true;
+      continue;
+    }
+
+    if (*arg=="-b") {
+      subsumption = true;
+      continue;
+    }
+
+    if (*arg=="-e") {
+      elimination = true;
+      continue;
+    }
+
+    if (*arg=="-u") {
+      propagation = true;
+      continue;
+    }
+
+    if (*arg=="-q") {
+      equivalences = true;
+      continue;
+    }
+
+    // number of threads
+    if (*arg=="-j" && arg+1 != cmdline.cend()) {
+      try {
+        threads = thread_option(*(++arg));
+      } catch(...) {
+        usage(cerr,cmdline[0]);
+        exit(-1);
+      }
+      continue;
+    }
+
+    // width specification
     int value;
     try {
 
-      value = -std::stoi(cmdline[1]);
+      if ((*arg)[0]!='-') throw std::invalid_argument{"Unknown option."};
+      value = -std::stoi(*arg);
       if (value < 3) throw std::out_of_range{"The target width must be 3 or more."};
       target_width = value;
 
@@ -106,10 +304,44 @@ int main(int argc, char *argv[])
       exit(-1);
     }
   }
-    
+
+  if (streaming && (input_file.empty() || !cache_file.empty() || preprocess || subsumption || elimination || propagation || equivalences || renumbering || !extension_file.empty() || factoring)) {
+    usage(cerr,cmdline[0]);
+    exit(-1);
+  }
+
+  if ((factoring && strategy_given) || (!map_file.empty() && !renumbering)) {
+    usage(cerr,cmdline[0]);
+    exit(-1);
+  }
+
+  // output file, compressed according to its extension
+  std::unique_ptr<compressed_ofstream> output {};
+  std::ostream* out = &cout;
+  if (!output_file.empty()) {
+    try {
+      output.reset(new compressed_ofstream{output_file});
+      out = output.get();
+    } catch(const std::exception& e) {
+      cerr<<"Cannot write the output file: "<<e.what()<<endl;
+      exit(-1);
+    }
+  }
+
   cnf F;
   try {
-    cin>>F;
+    if (streaming) {
+      cnf2kcnf_stream(input_file, target_width, *out, strategy);
+      close_output(output);
+      exit(0);
+    }
+    if (!input_file.empty())
+      F = load_cnf_file(input_file,threads);
+    else
+      F = read_cnf(cin);
+  } catch(const std::system_error& e) {
+    cerr<<"Cannot read the input file: "<<e.what()<<endl;
+    exit(-1);
   } catch(dimacs_bad_syntax e) {
     cerr<<"Error in parsing the dimacs input file."<<endl;
     exit(-1);
@@ -119,10 +351,104 @@ int main(int argc, char *argv[])
   } catch(dimacs_bad_value e) {
     cerr<<"The CNF formula dimacs file is inconsistent."<<endl;
     exit(-1);
+  } catch(const cnf_cache_invalid& e) {
+    cerr<<"Error in reading the binary cnf file: "<<e.what()<<endl;
+    exit(-1);
+  } catch(const compression_error& e) {
+    cerr<<"Error in decompressing the input: "<<e.what()<<endl;
+    exit(-1);
   }
 
-  
-  std::cout<<cnf2kcnf(F, target_width);
+  if (!cache_file.empty()) {
+    try {
+      compressed_ofstream cache {cache_file};
+      write_cnf_cache(cache,F);
+      cache.close();
+    } catch(const std::exception& e) {
+      cerr<<"Cannot write the binary cnf file "<<cache_file<<": "<<e.what()<<endl;
+      exit(-1);
+    }
+  }
+
+  std::ofstream extension {};
+  if (!extension_file.empty()) {
+    extension.open(extension_file);
+    if (!extension) {
+      cerr<<"Cannot write the extension file "<<extension_file<<"."<<endl;
+      exit(-1);
+    }
+  }
+
+  // an unsatisfiable formula skips the other steps
+  if (propagation) {
+    vector<literal> assigned;
+    propagate_stats stats;
+    F = propagate(F,assigned,stats);
+    if (stats.conflict)
+      unsatisfiable(*out,output,F,"Unit propagation finds a conflict");
+    if (!extension_file.empty() && !assigned.empty()) {
+      extension<<"v";
+      for (literal lit : assigned) extension<<" "<<lit;
+      extension<<" 0\n";
+    }
+  }
+  if (equivalences) {
+    vector<literal> representative;
+    equivalence_stats stats;
+    F = substitute_equivalences(F,representative,stats);
+    if (stats.conflict)
+      unsatisfiable(*out,output,F,"Some literal is equivalent to its negation");
+    if (!extension_file.empty())
+      for (variable v=1; static_cast<size_t>(v)<representative.size(); ++v)
+        if (representative[v]!=v)
+          extension<<"q "<<v<<" "<<representative[v]<<" 0\n";
+  }
+
+  if (subsumption)
+    F = subsume(F);
+  else if (preprocess)
+    F = simplify(F);
+  if (elimination) {
+    elimination_stack stack;
+    eliminate_stats stats;
+    F = eliminate(F,{},stack,stats);
+    if (stats.conflict)
+      unsatisfiable(*out,output,F,"Variable elimination finds the empty clause");
+    if (!extension_file.empty())
+      for (size_t i=0; i<stack.size(); ++i) {
+        extension<<"e";
+        for (literal lit : stack[i]) extension<<" "<<lit;
+        extension<<" 0\n";
+      }
+  }
+
+  if (!extension_file.empty()) {
+    extension.close();
+    if (!extension) {
+      cerr<<"Cannot write the extension file "<<extension_file<<"."<<endl;
+      exit(-1);
+    }
+  }
+
+  if (renumbering) {
+    vector<variable> original;
+    F = renumber(F,original,order);
+    if (!map_file.empty()) {
+      std::ofstream map {map_file};
+      write_variable_map(map,original);
+      map.close();
+      if (!map) {
+        cerr<<"Cannot write the map file "<<map_file<<"."<<endl;
+        exit(-1);
+      }
+    }
+  }
+
+  if (factoring)
+    (*out)<<cnf2kcnf_factored(F, target_width);
+  else
+    (*out)<<cnf2kcnf(F, target_width, threads, strategy);
+  close_output(output);
   
   exit(0);
 }
@@ -0,0 +1,256 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 16:50 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 16:50 (CEST) Massimo Lauria"
+
+  Description::
+
+  Binary files for cnf objects.
+
+  Implementation file: see the header file `cnf_cache.hh` for actual
+  documentation.
+
+*/
+
+// Preamble
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+#include "cnf_cache.hh"
+#include "compression.hh"
+#include "dimacs_io.hh"
+#include "mapped_file.hh"
+
+using std::string;
+using std::vector;
+
+
+// Code
+
+const char cnf_cache_magic[8] {'\x89','C','N','F','\r','\n','\x1a','\n'};
+
+static const uint32_t cache_version   {1};
+static const uint32_t cache_byteorder {0x01020304};
+
+struct cache_header {
+  char     magic[8];
+  uint32_t version;
+  uint32_t byteorder;
+  uint64_t variables;
+  uint64_t clauses;
+  uint64_t literals;
+  uint64_t checksum;
+};
+
+static_assert(sizeof(cache_header)==48,"Unexpected padding in the cache header.");
+static_assert(sizeof(literal)==sizeof(int32_t),"Literals are stored as 32-bit integers.");
+
+
+// Hash of a byte array. The data is consumed 32 bytes at a time on
+// four independent lanes, so that the hash is limited by the memory
+// bandwidth rather than by the latency of the multiplications.
+static inline uint64_t rotate_left(uint64_t x,int bits) {
+  return (x<<bits) | (x>>(64-bits));
+}
+
+static uint64_t hash_bytes(const char* p,size_t length,uint64_t seed) {
+  const uint64_t prime1 {0x9E3779B185EBCA87ULL};
+  const uint64_t prime2 {0xC2B2AE3D27D4EB4FULL};
+
+  uint64_t lane[4] {seed+prime1, seed+prime2, seed, seed-prime1};
+  const char* end = p+length;
+
+  for (; end-p>=32; p+=32) {
+    for (int i=0; i<4; ++i) {
+      uint64_t word;
+      std::memcpy(&word,p+8*i,sizeof(word));
+      lane[i] = rotate_left(lane[i] + word*prime2, 31) * prime1;
+    }
+  }
+
+  uint64_t h = rotate_left(lane[0],1) + rotate_left(lane[1],7) +
+               rotate_left(lane[2],12) + rotate_left(lane[3],18) + length;
+  for (; p<end; ++p)
+    h = rotate_left(h ^ (static_cast<unsigned char>(*p)*prime1), 11) * prime2;
+
+  h ^= h >> 33;
+  h *= prime2;
+  h ^= h >> 29;
+  return h;
+}
+
+// The checksum is the hash of the header (except for the checksum
+// field, which is the last one), chained with the hashes of the blocks
+// of the two arrays. Blocks fit in the cache, so that a reader can
+// hash, copy and check each block while reading it once from memory.
+static const size_t cache_block {1<<16};
+
+static uint64_t header_hash(const cache_header& header) {
+  return hash_bytes(reinterpret_cast<const char*>(&header),
+                    sizeof(header)-sizeof(header.checksum), 0);
+}
+
+static uint64_t blocks_hash(const char* p,size_t length,uint64_t h) {
+  for (size_t i=0; i<length; i+=cache_block)
+    h = hash_bytes(p+i, std::min(cache_block,length-i), h);
+  return h;
+}
+
+template <typename T>
+static inline T load(const char* p) {
+  T value;
+  std::memcpy(&value,p,sizeof(value));
+  return value;
+}
+
+
+void write_cnf_cache(std::ostream& out,const cnf& F) {
+
+  // offsets are stored as 64-bit integers whatever the size of size_t
+  vector<uint64_t> converted {};
+  const char* offsets = reinterpret_cast<const char*>(F.offsets.data());
+  if (sizeof(size_t)!=sizeof(uint64_t)) {
+    converted.assign(F.offsets.begin(),F.offsets.end());
+    offsets = reinterpret_cast<const char*>(converted.data());
+  }
+  const char* literals = reinterpret_cast<const char*>(F.literals.data());
+
+  cache_header header;
+  std::memcpy(header.magic,cnf_cache_magic,sizeof(header.magic));
+  header.version   = cache_version;
+  header.byteorder = cache_byteorder;
+  header.variables = F.variables_number();
+  header.clauses   = F.size();
+  header.literals  = F.literals_number();
+  header.checksum  = blocks_hash(literals, F.literals_number()*sizeof(int32_t),
+                                 blocks_hash(offsets, (F.size()+1)*sizeof(uint64_t),
+                                             header_hash(header)));
+
+  out.write(reinterpret_cast<const char*>(&header),sizeof(header));
+  out.write(offsets,(F.size()+1)*sizeof(uint64_t));
+  out.write(literals,F.literals_number()*sizeof(int32_t));
+}
+
+
+bool is_cnf_cache(const char* begin,const char* end) {
+  return end-begin >= static_cast<std::ptrdiff_t>(sizeof(cnf_cache_magic)) &&
+    std::memcmp(begin,cnf_cache_magic,sizeof(cnf_cache_magic))==0;
+}
+
+
+cnf read_cnf_cache(const char* begin,const char* end) {
+
+  if (!is_cnf_cache(begin,end))
+    throw cnf_cache_invalid{"Not a binary cnf file."};
+
+  cache_header header;
+  size_t length = end-begin;
+  if (length < sizeof(header))
+    throw cnf_cache_invalid{"Truncated binary cnf file."};
+  std::memcpy(&header,begin,sizeof(header));
+
+  if (header.version!=cache_version)
+    throw cnf_cache_invalid{"Unsupported version of the binary cnf format."};
+  if (header.byteorder!=cache_byteorder)
+    throw cnf_cache_invalid{"The binary cnf file has been written with a different byte order."};
+  if (header.variables > INT_MAX)
+    throw cnf_cache_invalid{"Too many variables in the binary cnf file."};
+
+  // sizes are checked without overflows
+  uint64_t payload = length - sizeof(header);
+  uint64_t m = header.clauses;
+  uint64_t L = header.literals;
+  if (m >= payload/sizeof(uint64_t) || L > payload/sizeof(int32_t) ||
+      (m+1)*sizeof(uint64_t) + L*sizeof(int32_t) != payload)
+    throw cnf_cache_invalid{"The size of the binary cnf file does not match its header."};
+
+  const char* offsets  = begin + sizeof(header);
+  const char* literals = offsets + (m+1)*sizeof(uint64_t);
+
+  // Each block is hashed, copied and checked while it is in the
+  // cache. Checks have no early exit, so that the loops vectorize: the
+  // checksum does not protect against a wrong writer.
+  cnf F {static_cast<variable>(header.variables)};
+  uint64_t h = header_hash(header);
+  bool bad_offsets  = load<uint64_t>(offsets)!=0 || load<uint64_t>(literals-sizeof(uint64_t))!=L;
+  bool bad_literals = false;
+
+  F.offsets.reserve(m+1);
+  for (size_t i=0; i<=m; i+=cache_block/sizeof(uint64_t)) {
+    size_t last = std::min<size_t>(m+1, i+cache_block/sizeof(uint64_t));
+    h = hash_bytes(offsets+i*sizeof(uint64_t), (last-i)*sizeof(uint64_t), h);
+    F.offsets.resize(last);
+    size_t* target = F.offsets.data();
+    uint64_t bad {0};
+    for (size_t j=std::max<size_t>(i,1); j<last; ++j) {
+      uint64_t value = load<uint64_t>(offsets+j*sizeof(uint64_t));
+      uint64_t previous = load<uint64_t>(offsets+(j-1)*sizeof(uint64_t));
+      // value<2^63, value<=L and previous<=value, without 64-bit
+      // comparisons, which SSE2 does not have
+      bad |= (value | (L-value) | (value-previous)) >> 63;
+      target[j] = static_cast<size_t>(value);
+    }
+    bad_offsets |= bad;
+  }
+
+  // lit is good iff it is in [-n,n] and it is not zero
+  const uint32_t n = F.variables_number();
+  F.literals.reserve(L);
+  for (size_t i=0; i<L; i+=cache_block/sizeof(int32_t)) {
+    size_t last = std::min<size_t>(L, i+cache_block/sizeof(int32_t));
+    h = hash_bytes(literals+i*sizeof(int32_t), (last-i)*sizeof(int32_t), h);
+    F.literals.resize(last);
+    literal* target = F.literals.data();
+    unsigned int bad {0};
+    for (size_t j=i; j<last; ++j) {
+      literal lit = load<int32_t>(literals+j*sizeof(int32_t));
+      bad |= (static_cast<uint32_t>(lit)+n > 2*n) | (lit==null_literal);
+      target[j] = lit;
+    }
+    bad_literals |= bad;
+  }
+
+  if (h!=header.checksum)
+    throw cnf_cache_invalid{"Wrong checksum in the binary cnf file."};
+  if (bad_offsets)
+    throw cnf_cache_invalid{"Inconsistent clause offsets in the binary cnf file."};
+  if (bad_literals)
+    throw cnf_cache_invalid{"Literal out of range in the binary cnf file."};
+
+  return F;
+}
+
+
+// binary cache or dimacs file, from a stream of uncompressed data
+static cnf read_uncompressed(std::istream& in) {
+  if (in.peek()==static_cast<unsigned char>(cnf_cache_magic[0])) {
+    string data {std::istreambuf_iterator<char>{in},std::istreambuf_iterator<char>{}};
+    return read_cnf_cache(data.data(),data.data()+data.size());
+  }
+  return parse_dimacs(in);
+}
+
+cnf read_cnf(std::istream& in) {
+  auto format = compression_by_magic(in);
+  if (format!=compression::none) {
+    decompressing_istream data {in,format};
+    return read_uncompressed(data);
+  }
+  return read_uncompressed(in);
+}
+
+cnf load_cnf_file(const string& path,unsigned int threads) {
+  mapped_file file {path};
+
+  auto format = compression_by_magic(file.begin(),file.end());
+  if (format!=compression::none) {
+    decompressing_istream in {file.begin(),file.end(),format};
+    return read_uncompressed(in);
+  }
+  if (is_cnf_cache(file.begin(),file.end()))
+    return read_cnf_cache(file.begin(),file.end());
+  return parse_dimacs(file.begin(),file.end(),threads);
+}
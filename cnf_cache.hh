@@ -0,0 +1,88 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 16:50 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 16:50 (CEST) Massimo Lauria"
+
+  Description::
+
+  Binary files for `cnf` objects.
+
+  Parsing a large dimacs file is expensive. A formula which is read
+  many times can be saved once in a binary file, the *cache*, which
+  is a dump of the memory layout of a `cnf` object and can be loaded
+  with essentially a copy.
+
+     std::ofstream out {"formula.cnfc", std::ios::binary};
+     write_cnf_cache(out,F);
+     ...
+     cnf G {load_cnf_file("formula.cnfc")};
+
+  The format (version 1) is
+
+     magic      8 bytes  "\x89CNF\r\n\x1a\n"
+     version    uint32   1
+     byteorder  uint32   0x01020304
+     variables  uint64   number of variables
+     clauses    uint64   number of clauses m
+     literals   uint64   number of literals L
+     checksum   uint64   hash of the other fields and of the arrays
+     offsets    uint64[m+1]   clause i is literals [offsets[i],offsets[i+1])
+     literals   int32[L]
+
+  The checksum is a 64-bit hash of the header and of the arrays,
+  computed on blocks of 64 KiB so that a reader can verify, copy and
+  check each block while it is in the processor cache.
+
+  All numbers are in the byte order of the machine which wrote the
+  file: the `byteorder` field lets the reader detect a file from a
+  machine with a different order, which is rejected. The magic
+  string starts with a byte which is not valid in a dimacs file, so
+  the two formats can be told apart from the first byte.
+
+  When a cache is read, the header, the size of the file, the
+  checksum and the consistency of the offsets and of the literals
+  are all checked, and a `cnf_cache_invalid` exception is thrown if
+  anything is wrong.
+*/
+
+#ifndef _CNF_CACHE_HH_
+#define _CNF_CACHE_HH_
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "cnf.hh"
+
+
+// Magic string at the beginning of a cache file.
+extern const char cnf_cache_magic[8];
+
+// Write the formula F in binary format.
+void write_cnf_cache(std::ostream& out,const cnf& F);
+
+// Whether [begin,end) starts as a binary cache.
+bool is_cnf_cache(const char* begin,const char* end);
+
+// Read a formula from the binary cache in [begin,end).
+cnf read_cnf_cache(const char* begin,const char* end);
+
+// Read a formula from the file at `path`, which is either a binary
+// cache or a dimacs file (parsed with `threads` threads), possibly
+// compressed (see `compression.hh`). The format is detected from the
+// content of the file.
+cnf load_cnf_file(const std::string& path,unsigned int threads=1);
+
+// Same as above, for a formula read from a stream.
+cnf read_cnf(std::istream& in);
+
+
+// Errors in binary caches
+class cnf_cache_invalid : public std::invalid_argument {
+  public:
+    cnf_cache_invalid(const std::string& data) : std::invalid_argument{data} {}
+};
+
+
+#endif /* _CNF_CACHE_HH_ */
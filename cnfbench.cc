@@ -0,0 +1,473 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 10:40 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 16:25 (CEST) Massimo Lauria"
+
+  Description::
+
+  Throughput measurements for the cnftools library.
+
+  Two random formulas are generated in memory (see `cnfgen.hh`): a
+  k-CNF and a formula with wide clauses, of widths up to W. The second
+  one, by default, has about as many literals as the first. Each
+  formula is printed as dimacs text, and then the following tasks are
+  timed separately on it
+
+    parse_dimacs     parse the dimacs text (in memory), with each
+                     scanner of the tokenizer supported by the
+                     processor (see `dimacs_reader.hh`);
+    cnf2kcnf         transform the formula into a k'-CNF, with each
+                     splitting strategy and with factoring (the record
+                     has also the size of the output formula);
+    cnf2kcnf_incremental
+                     transform the last 1000 clauses of the formula,
+                     after the others (see `kcnf_incremental`);
+    simplify         remove repeated literals, tautologies and repeated
+                     clauses;
+    occurrence_list  build the occurrence lists of the formula;
+    subsume          remove subsumed clauses and strengthen clauses;
+    eliminate        bounded variable elimination;
+    propagate        unit propagation and pure literals;
+    substitute_equivalences
+                     replace equivalent literals given by the binary
+                     clauses;
+    renumber         number the variables in reverse Cuthill-McKee
+                     order;
+    operator<<       print the formula, to a stream which discards
+                     the data;
+    write_cnf_cache  save the formula in binary format, to a stream
+                     which discards the data;
+    read_cnf_cache   load the formula from binary format in memory.
+
+  The parser and the transformation are also timed on several threads
+  when option -j is given. Two reference implementations give a
+  baseline for comparison: a parser based on `istream >> int` and a
+  writer based on the formatted output of iostreams, which is how the
+  library used to read and print formulas. The speed of a plain copy
+  of the binary file is the reference for `read_cnf_cache`.
+
+  Each task runs several times. The results are printed on standard
+  output as a JSON document, with one record per task:
+
+    bytes            size of the dimacs text (input for parse_dimacs
+                     and cnf2kcnf, output for the writers), or of the
+                     binary file;
+    seconds          best running time among the rounds;
+    mb_per_s         bytes/seconds, in millions;
+    clauses_per_s    clauses of the input formula per second;
+    allocations      heap allocations in one round;
+    heap_peak_bytes  largest growth of the heap during one round;
+    peak_rss_kb      peak resident memory of the whole process after
+                     the task (it includes the formulas held by the
+                     benchmark, and never decreases).
+
+  Heap usage is measured by replacing the global operator new and
+  delete.
+*/
+
+// Preamble
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "cnftools.hh"
+#include "parallel.hh"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+
+// Heap accounting: every allocation is prefixed by its size. The
+// counters are atomic since tasks on several threads allocate too.
+static std::atomic<size_t> heap_allocations {0};
+static std::atomic<size_t> heap_bytes {0};
+static std::atomic<size_t> heap_peak {0};
+
+void* operator new(size_t size) {
+  auto* block = static_cast<size_t*>(std::malloc(size+sizeof(std::max_align_t)));
+  if (block==nullptr) throw std::bad_alloc{};
+  *block = size;
+  ++heap_allocations;
+  size_t bytes = (heap_bytes += size);
+  size_t peak  = heap_peak.load();
+  while (peak<bytes && !heap_peak.compare_exchange_weak(peak,bytes)) {}
+  return reinterpret_cast<char*>(block)+sizeof(std::max_align_t);
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr==nullptr) return;
+  auto* block = reinterpret_cast<size_t*>(static_cast<char*>(ptr)-sizeof(std::max_align_t));
+  heap_bytes -= *block;
+  std::free(block);
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+
+
+// Peak resident memory of the process, in kilobytes.
+static long peak_rss_kb() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF,&usage)!=0) return 0;
+  return usage.ru_maxrss;
+}
+
+
+// Reference parser: the clause body is read with formatted input, one
+// literal at a time. The spec line is assumed to be correct.
+static cnf parse_with_istream(const string& data) {
+  std::istringstream in {data};
+  string line;
+  do { getline(in,line); } while (line[0]!='p');
+
+  std::istringstream specline {line};
+  string p, format;
+  variable n;
+  size_t m;
+  specline>>p>>format>>n>>m;
+
+  cnf formula {n};
+  clause c;
+  literal lit;
+  for (size_t i=0; i<m; ++i) {
+    c.resize(0);
+    while (in>>lit && lit!=null_literal) c.push_back(lit);
+    formula.add_clause(c);
+  }
+  return formula;
+}
+
+
+// A stream buffer which counts and discards characters.
+class null_buffer : public std::streambuf {
+  public:
+    size_t count {0};
+  protected:
+    int overflow(int c) override { ++count; return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { count+=n; return n; }
+};
+
+// Reference writer: formatted output and a flush per clause.
+static void write_with_ostream(std::ostream& out,const cnf& F) {
+  out<<"p cnf "<<F.variables_number()<<" "<<F.size()<<endl;
+  for (auto c : F) {
+    if (c.size()>0) out<<c[0];
+    for (size_t i=1; i<c.size(); ++i) out<<" "<<c[i];
+    out<<" 0"<<endl;
+  }
+}
+
+
+// Results of a task.
+struct measurement {
+  double seconds        {0};
+  size_t allocations    {0};
+  size_t heap_peak      {0};
+};
+
+// Run `task` several times. The value returned by the task is only
+// written to a volatile variable, to keep the compiler from optimizing
+// the work away.
+static volatile size_t task_result {0};
+
+template <typename Task>
+static measurement measure(int rounds, Task task) {
+  measurement result {};
+  for (int r=0; r<rounds; ++r) {
+    size_t allocations = heap_allocations;
+    size_t start_bytes = heap_bytes;
+    heap_peak = start_bytes;
+
+    auto start = std::chrono::steady_clock::now();
+    task_result = task();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (r==0 || elapsed.count() < result.seconds) result.seconds = elapsed.count();
+    result.allocations = heap_allocations - allocations;
+    result.heap_peak   = std::max(result.heap_peak, heap_peak - start_bytes);
+  }
+  return result;
+}
+
+
+// JSON output, one record per task.
+class report {
+
+  private:
+
+    std::ostream& out;
+    bool first {true};
+
+    static double rate(double amount,double seconds) {
+      return seconds>0 ? amount/seconds : 0;
+    }
+
+  public:
+
+    report(std::ostream& out, variable n, size_t m, size_t k, size_t w,
+           size_t target, unsigned int threads, int rounds, uint64_t seed) : out(out) {
+      out<<"{"<<endl;
+      out<<"  \"parameters\": {\"variables\": "<<n<<", \"clauses\": "<<m
+         <<", \"width\": "<<k<<", \"wide_width\": "<<w
+         <<", \"target_width\": "<<target<<", \"threads\": "<<threads
+         <<", \"rounds\": "<<rounds<<", \"seed\": "<<seed<<"},"<<endl;
+      out<<"  \"results\": [";
+    }
+
+    ~report() {
+      out<<endl<<"  ]"<<endl<<"}"<<endl;
+    }
+
+    // `details` are more fields of the record, in JSON
+    void add(const string& formula, const cnf& F, const string& task,
+             unsigned int threads, size_t bytes, const measurement& result,
+             const string& details = "") {
+      out<<(first ? "" : ",")<<endl;
+      first = false;
+      out<<"    {\"formula\": \""<<formula<<"\""
+         <<", \"variables\": "<<F.variables_number()
+         <<", \"clauses\": "<<F.size()
+         <<", \"literals\": "<<F.literals_number()
+         <<", \"task\": \""<<task<<"\""
+         <<", \"threads\": "<<threads
+         <<", \"bytes\": "<<bytes
+         <<", \"seconds\": "<<result.seconds
+         <<", \"mb_per_s\": "<<rate(bytes/1e6,result.seconds)
+         <<", \"clauses_per_s\": "<<rate(F.size(),result.seconds)
+         <<", \"allocations\": "<<result.allocations
+         <<", \"heap_peak_bytes\": "<<result.heap_peak
+         <<", \"peak_rss_kb\": "<<peak_rss_kb()
+         <<details<<"}";
+    }
+};
+
+
+// Time all tasks on formula F.
+static void run_tasks(report& results, const string& name, const cnf& F,
+                      size_t target, unsigned int threads, int rounds) {
+  string text;
+  {
+    std::ostringstream out;
+    out<<F;
+    text = out.str();
+  }
+
+  vector<unsigned int> configurations {1};
+  if (threads>1) configurations.push_back(threads);
+
+  // parser, with each scanner supported by the processor
+  const auto active = dimacs_active_scanner();
+  const std::pair<dimacs_scanner,string> scanners[] {
+    {dimacs_scanner::scalar,"scalar"},
+    {dimacs_scanner::sse2,"sse2"},
+    {dimacs_scanner::avx2,"avx2"}};
+  for (const auto& s : scanners) {
+    if (!dimacs_scanner_supported(s.first)) continue;
+    dimacs_set_scanner(s.first);
+    for (auto t : configurations) {
+      auto result = measure(rounds, [&]() { return parse_dimacs(text,t).size(); });
+      results.add(name,F,"parse_dimacs",t,text.size(),result,
+                  ", \"scanner\": \""+s.second+"\"");
+    }
+  }
+  dimacs_set_scanner(active);
+  auto result = measure(rounds, [&]() { return parse_with_istream(text).size(); });
+  results.add(name,F,"parse_istream_reference",1,text.size(),result);
+
+  // transformation, with each splitting strategy
+  auto sizes = [](const string& split, const cnf& G) {
+    std::ostringstream details;
+    details<<", \"split\": \""<<split<<"\""
+           <<", \"output_variables\": "<<G.variables_number()
+           <<", \"output_clauses\": "<<G.size()
+           <<", \"output_literals\": "<<G.literals_number();
+    return details.str();
+  };
+  for (auto strategy : {split_strategy::chain, split_strategy::tree}) {
+    string details {sizes(strategy==split_strategy::tree ? "tree" : "chain",
+                          cnf2kcnf(F,target,strategy))};
+    for (auto t : configurations) {
+      auto result = measure(rounds, [&]() { return cnf2kcnf(F,target,t,strategy).size(); });
+      results.add(name,F,"cnf2kcnf",t,text.size(),result,details);
+    }
+  }
+  {
+    string details {sizes("factored",cnf2kcnf_factored(F,target))};
+    auto result = measure(rounds, [&]() { return cnf2kcnf_factored(F,target).size(); });
+    results.add(name,F,"cnf2kcnf",1,text.size(),result,details);
+  }
+
+  // the last clauses of F, added to the translation of the others.
+  // The record is about the added clauses only.
+  {
+    size_t first {F.size()-std::min<size_t>(1000,F.size())};
+    cnf G {F};
+    G.truncate(first);
+    kcnf_incremental base {target};
+    base.translate(G);
+    cnf batch {};
+    for (size_t i=first; i<F.size(); ++i) {
+      G.add_clause(F[i]);
+      batch.add_clause(F[i]);
+    }
+    std::ostringstream out;
+    out<<batch;
+    auto result = measure(rounds, [&]() {
+        kcnf_incremental T {base};
+        G.set_watermark(first);
+        return T.translate(G).size(); });
+    results.add(name,batch,"cnf2kcnf_incremental",1,out.str().size(),result,
+                ", \"base_clauses\": "+std::to_string(first));
+  }
+
+  result = measure(rounds, [&]() { return simplify(F).size(); });
+  results.add(name,F,"simplify",1,text.size(),result);
+
+  result = measure(rounds, [&]() { return occurrence_list{F}.size(); });
+  results.add(name,F,"occurrence_list",1,text.size(),result);
+
+  result = measure(rounds, [&]() { return subsume(F).size(); });
+  results.add(name,F,"subsume",1,text.size(),result);
+
+  result = measure(rounds, [&]() { return eliminate(F).size(); });
+  results.add(name,F,"eliminate",1,text.size(),result);
+
+  result = measure(rounds, [&]() { return propagate(F).size(); });
+  results.add(name,F,"propagate",1,text.size(),result);
+
+  result = measure(rounds, [&]() { return substitute_equivalences(F).size(); });
+  results.add(name,F,"substitute_equivalences",1,text.size(),result);
+
+  result = measure(rounds, [&]() {
+      vector<variable> original;
+      return renumber(F,original,variable_order::reverse_cuthill_mckee).size(); });
+  results.add(name,F,"renumber",1,text.size(),result);
+
+  // writer
+  size_t written {0};
+  result = measure(rounds, [&]() {
+      null_buffer sink;
+      std::ostream out {&sink};
+      out<<F;
+      return written = sink.count; });
+  results.add(name,F,"operator<<",1,written,result);
+
+  result = measure(rounds, [&]() {
+      null_buffer sink;
+      std::ostream out {&sink};
+      write_with_ostream(out,F);
+      return written = sink.count; });
+  results.add(name,F,"write_ostream_reference",1,written,result);
+
+  // binary cache
+  string cache;
+  {
+    std::ostringstream out;
+    write_cnf_cache(out,F);
+    cache = out.str();
+  }
+  result = measure(rounds, [&]() {
+      null_buffer sink;
+      std::ostream out {&sink};
+      write_cnf_cache(out,F);
+      return sink.count; });
+  results.add(name,F,"write_cnf_cache",1,cache.size(),result);
+
+  result = measure(rounds, [&]() {
+      return read_cnf_cache(cache.data(),cache.data()+cache.size()).size(); });
+  results.add(name,F,"read_cnf_cache",1,cache.size(),result);
+
+  vector<char> copy(cache.size()+1);
+  result = measure(rounds, [&]() {
+      std::memcpy(copy.data(),cache.data(),cache.size());
+      return static_cast<size_t>(copy[cache.size()/2]); });
+  results.add(name,F,"memcpy_reference",1,cache.size(),result);
+}
+
+
+void usage(std::ostream &err,string programname) {
+  err<<"Usage: "<<programname<<" [-n <vars>] [-m <clauses>] [-k <width>] [-w <width>] [-M <clauses>]"<<endl
+     <<"       "<<string(programname.size(),' ')<<" [-t <width>] [-j <threads>] [-r <rounds>] [-s <seed>]"<<endl<<endl;
+  err<<"   -n  number of variables of the random formulas (default 100000)"<<endl;
+  err<<"   -m  number of clauses of the random k-CNF (default 1000000)"<<endl;
+  err<<"   -k  width of the clauses of the random k-CNF (default 3)"<<endl;
+  err<<"   -w  largest clause width in the wide formula (default 100)"<<endl;
+  err<<"   -M  number of clauses of the wide formula (default: about"<<endl;
+  err<<"       as many literals as the k-CNF)"<<endl;
+  err<<"   -t  target width of cnf2kcnf (default 3)"<<endl;
+  err<<"   -j  also run the parser and cnf2kcnf on this many threads"<<endl;
+  err<<"       (0 for one per core)"<<endl;
+  err<<"   -r  how many times each measure is repeated (default 3)"<<endl;
+  err<<"   -s  seed of the random formulas (default 1)"<<endl;
+}
+
+
+// Value of an option which must be a positive integer. Values are
+// parsed as signed, so that negative ones are rejected instead of
+// wrapping around.
+static size_t positive_option(const string& value) {
+  long long x {std::stoll(value)};
+  if (x<1) throw std::out_of_range{"The value must be positive."};
+  return static_cast<size_t>(x);
+}
+
+
+int main(int argc, char *argv[])
+{
+  variable     n       {100000};
+  size_t       m       {1000000};
+  size_t       k       {3};
+  size_t       w       {100};
+  size_t       M       {0};
+  size_t       target  {3};
+  unsigned int threads {1};
+  int          rounds  {3};
+  uint64_t     seed    {1};
+
+  vector<string> cmdline(argv,argv+argc);
+  try {
+    for (size_t i=1; i<cmdline.size(); ++i) {
+      if (i+1==cmdline.size()) throw std::invalid_argument{"missing value"};
+      if      (cmdline[i]=="-n") n       = std::stoi(cmdline[++i]);
+      else if (cmdline[i]=="-m") m       = positive_option(cmdline[++i]);
+      else if (cmdline[i]=="-k") k       = positive_option(cmdline[++i]);
+      else if (cmdline[i]=="-w") w       = positive_option(cmdline[++i]);
+      else if (cmdline[i]=="-M") M       = positive_option(cmdline[++i]);
+      else if (cmdline[i]=="-t") target  = positive_option(cmdline[++i]);
+      else if (cmdline[i]=="-j") threads = thread_option(cmdline[++i]);
+      else if (cmdline[i]=="-r") rounds  = std::stoi(cmdline[++i]);
+      else if (cmdline[i]=="-s") seed    = std::stoull(cmdline[++i]);
+      else throw std::invalid_argument{"unknown option"};
+    }
+    if (n<1 || target<3 || rounds<1) throw std::out_of_range{"bad value"};
+  } catch(...) {
+    usage(cerr,cmdline[0]);
+    exit(-1);
+  }
+
+  if (M==0) M = std::max<size_t>(1, m*k*2/(w+1));
+
+  {
+    report results {cout,n,m,k,w,target,threads,rounds,seed};
+
+    cnf F {random_kcnf(n,m,k,seed)};
+    run_tasks(results,"random-"+std::to_string(k)+"-cnf",F,target,threads,rounds);
+
+    F = random_wide_cnf(n,M,w,seed);
+    run_tasks(results,"wide-"+std::to_string(w),F,target,threads,rounds);
+  }
+
+  exit(0);
+}
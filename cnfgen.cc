@@ -0,0 +1,78 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 16:10 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 16:10 (CEST) Massimo Lauria"
+
+  Description::
+
+  Random formulas.
+
+  Implementation file: see the header file `cnfgen.hh` for actual
+  documentation.
+
+*/
+
+// Preamble
+#include <stdexcept>
+
+#include "cnfgen.hh"
+
+
+// Code
+
+// splitmix64 generator
+class random_source {
+
+  private:
+
+    uint64_t state;
+
+  public:
+
+    explicit random_source(uint64_t seed): state{seed} {}
+
+    uint64_t next() {
+      uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      return z ^ (z >> 31);
+    }
+
+    // uniform in [1,n] (up to a negligible bias)
+    uint64_t uniform(uint64_t n) { return 1 + next()%n; }
+
+    literal random_literal(variable n) {
+      uint64_t r = next();
+      return toliteral(static_cast<variable>(1 + (r>>1)%n), r&1);
+    }
+};
+
+
+static cnf random_formula(variable n,size_t m,size_t minwidth,size_t maxwidth,uint64_t seed) {
+  if (n<1)
+    throw std::invalid_argument{"Random formulas need at least one variable."};
+
+  random_source random {seed};
+  cnf F {n};
+  clause c;
+
+  F.reserve(m,m*(minwidth+maxwidth)/2);
+  for (size_t i=0; i<m; ++i) {
+    size_t width = minwidth + random.uniform(maxwidth-minwidth+1) - 1;
+    c.resize(0);
+    for (size_t j=0; j<width; ++j) c.push_back(random.random_literal(n));
+    F.add_clause(c);
+  }
+  return F;
+}
+
+cnf random_kcnf(variable n,size_t m,size_t k,uint64_t seed) {
+  return random_formula(n,m,k,k,seed);
+}
+
+cnf random_wide_cnf(variable n,size_t m,size_t w,uint64_t seed) {
+  if (w<1)
+    throw std::invalid_argument{"Clause width must be positive."};
+  return random_formula(n,m,1,w,seed);
+}
@@ -0,0 +1,39 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 16:10 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 16:10 (CEST) Massimo Lauria"
+
+  Description::
+
+  Random formulas, for tests and benchmarks.
+
+  `random_kcnf(n,m,k,seed)` is a formula on n variables with m clauses
+  of exactly k literals. Each literal is on a variable chosen uniformly
+  at random (so a clause may mention a variable more than once), with
+  a random sign.
+
+  `random_wide_cnf(n,m,w,seed)` is the same but the width of each
+  clause is uniform between 1 and w, which gives formulas with many
+  wide clauses, similar to the encodings of pseudo-Boolean
+  constraints.
+
+  The formulas only depend on the arguments: random numbers come from
+  a fixed generator (splitmix64) and are mapped to ranges without the
+  implementation defined distributions of the standard library, so
+  the same seed gives the same formula on every platform.
+*/
+
+#ifndef _CNFGEN_HH_
+#define _CNFGEN_HH_
+
+#include <cstdint>
+
+#include "cnf.hh"
+
+
+cnf random_kcnf(variable n,size_t m,size_t k,uint64_t seed);
+cnf random_wide_cnf(variable n,size_t m,size_t w,uint64_t seed);
+
+
+#endif /* _CNFGEN_HH_ */
@@ -0,0 +1,195 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 23:58 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 23:58 (CEST) Massimo Lauria"
+
+  Description::
+
+  Split a CNF formula into its connected components.
+
+  Each component (see `components.hh`) is written to the dimacs file
+  <prefix>-<i>.cnf, with its variables numbered from 1, and the
+  correspondence with the variables of the input is written to
+  <prefix>-<i>.map, one line "j v" for each variable. Components are
+  numbered from 1, in order of their smallest variable.
+
+  The components can be simplified and transformed into k-CNF as by
+  `cnf2kcnf` before they are written, on several threads, one
+  component at a time. The extension variables of the transformation
+  come after the variables of the component, and are not in the map.
+  A component which is found to be unsatisfiable is written as the
+  empty clause.
+
+  For each component a line "<file> <variables> <clauses>" is printed
+  on the standard output, followed by "unsatisfiable" if so.
+*/
+
+// Preamble
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "cnftools.hh"
+#include "parallel.hh"
+
+using std::cin;
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::string;
+using std::vector;
+
+
+void usage(std::ostream &err,string programname) {
+  err<<"Usage: "<<programname<<" [-i <file>] [-j <threads>] [-o <prefix>] [-k <width>] [-u] [-q] [-p] [-b] [-e]"<<endl<<endl;
+  err<<"   -i  read the formula from <file> instead of the standard input."<<endl;
+  err<<"   -j  number of threads used to parse the input file and to"<<endl;
+  err<<"       process the components (0 means one per core, default 1)."<<endl;
+  err<<"   -o  write the components to <prefix>-1.cnf, <prefix>-2.cnf..."<<endl;
+  err<<"       and their variables to <prefix>-1.map... (default"<<endl;
+  err<<"       \"component\")."<<endl;
+  err<<"   -k  transform each component into a k-CNF, as cnf2kcnf."<<endl;
+  err<<"   -u, -q, -p, -b, -e"<<endl;
+  err<<"       simplify each component, as cnf2kcnf."<<endl;
+}
+
+
+struct split_options {
+  size_t target_width  {0};     // 0 means no transformation
+  bool   propagation   {false};
+  bool   equivalences  {false};
+  bool   preprocess    {false};
+  bool   subsumption   {false};
+  bool   elimination   {false};
+};
+
+
+// Simplify and transform a component, in the same order as cnf2kcnf.
+// Return false if the component is unsatisfiable, and then F is the
+// empty clause.
+static bool process(cnf& F,const split_options& options) {
+  if (options.propagation) {
+    vector<literal> assigned;
+    propagate_stats stats;
+    F = propagate(F,assigned,stats);
+    if (stats.conflict) return false;
+  }
+  if (options.equivalences) {
+    vector<literal> representative;
+    equivalence_stats stats;
+    F = substitute_equivalences(F,representative,stats);
+    if (stats.conflict) return false;
+  }
+  if (options.subsumption)
+    F = subsume(F);
+  else if (options.preprocess)
+    F = simplify(F);
+  if (options.elimination) {
+    elimination_stack stack;
+    eliminate_stats stats;
+    F = eliminate(F,{},stack,stats);
+    if (stats.conflict) return false;
+  }
+  if (options.target_width>0)
+    F = cnf2kcnf(F,options.target_width,1,split_strategy::chain);
+  return true;
+}
+
+
+int main(int argc, char *argv[])
+{
+  string        input_file {};
+  string        prefix     {"component"};
+  unsigned int  threads    {1};
+  int           width      {0};
+  split_options options    {};
+
+  vector<string> cmdline(argv,argv+argc);
+  try {
+    for (size_t i=1; i<cmdline.size(); ++i) {
+      if      (cmdline[i]=="-u") { options.propagation  = true; continue; }
+      else if (cmdline[i]=="-q") { options.equivalences = true; continue; }
+      else if (cmdline[i]=="-p") { options.preprocess   = true; continue; }
+      else if (cmdline[i]=="-b") { options.subsumption  = true; continue; }
+      else if (cmdline[i]=="-e") { options.elimination  = true; continue; }
+      if (i+1==cmdline.size()) throw std::invalid_argument{"missing value"};
+      if      (cmdline[i]=="-i") input_file = cmdline[++i];
+      else if (cmdline[i]=="-o") prefix     = cmdline[++i];
+      else if (cmdline[i]=="-k") width      = std::stoi(cmdline[++i]);
+      else if (cmdline[i]=="-j") threads    = thread_option(cmdline[++i]);
+      else throw std::invalid_argument{"unknown option"};
+    }
+    if (width!=0 && width<3) throw std::out_of_range{"The target width must be 3 or more."};
+    options.target_width = static_cast<size_t>(width);
+  } catch(...) {
+    usage(cerr,cmdline[0]);
+    exit(-1);
+  }
+
+  cnf F;
+  try {
+    if (!input_file.empty())
+      F = load_cnf_file(input_file,threads);
+    else
+      F = read_cnf(cin);
+  } catch(const std::system_error& e) {
+    cerr<<"Cannot read the input file: "<<e.what()<<endl;
+    exit(-1);
+  } catch(const dimacs_bad_syntax& e) {
+    cerr<<"Error in parsing the dimacs input file."<<endl;
+    exit(-1);
+  } catch(const dimacs_truncated& e) {
+    cerr<<"Unexpected end of input."<<endl;
+    exit(-1);
+  } catch(const dimacs_bad_value& e) {
+    cerr<<"The CNF formula dimacs file is inconsistent."<<endl;
+    exit(-1);
+  } catch(const cnf_cache_invalid& e) {
+    cerr<<"Error in reading the binary cnf file: "<<e.what()<<endl;
+    exit(-1);
+  } catch(const compression_error& e) {
+    cerr<<"Error in decompressing the input: "<<e.what()<<endl;
+    exit(-1);
+  }
+
+  vector<cnf_component> components {split_components(F)};
+  F = cnf{};
+
+  // each task releases its component once it is written
+  vector<char> satisfiable(components.size(),1);
+  vector<variable> variables(components.size(),0);
+  vector<size_t> clauses(components.size(),0);
+  try {
+    parallel_for(components.size(),threads,[&](size_t i) {
+        cnf& G = components[i].formula;
+        satisfiable[i] = process(G,options);
+        variables[i] = G.variables_number();
+        clauses[i]   = G.size();
+
+        string name {prefix+"-"+std::to_string(i+1)};
+        compressed_ofstream out {name+".cnf"};
+        out<<G;
+        out.close();
+        std::ofstream map {name+".map"};
+        write_variable_map(map,components[i].variables);
+        map.close();
+        if (!map) throw std::runtime_error{"cannot write "+name+".map"};
+        components[i] = cnf_component{};
+      });
+  } catch(const std::exception& e) {
+    cerr<<"Cannot write the output file: "<<e.what()<<endl;
+    exit(-1);
+  }
+
+  for (size_t i=0; i<components.size(); ++i) {
+    cout<<prefix<<"-"<<(i+1)<<".cnf "<<variables[i]<<" "<<clauses[i];
+    if (!satisfiable[i]) cout<<" unsatisfiable";
+    cout<<endl;
+  }
+  exit(0);
+}
@@ -0,0 +1,214 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 21:10 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 21:10 (CEST) Massimo Lauria"
+
+  Description::
+
+  Statistics of a CNF formula, as a JSON document.
+
+  The formula is read in a single pass and its clauses are never
+  stored (see `statistics.hh`). The document has the fields
+
+    variables, clauses, literals   as in the input;
+    memory_bytes                   the formula stored in a `cnf`;
+    empty_clauses, units,
+    binaries, max_width,
+    mean_width                     about the widths of the clauses;
+    widths                         clauses of each width, as an
+                                   object {"width": clauses}, without
+                                   the widths which do not occur;
+    used_variables                 variables which occur;
+    pure_variables                 variables which occur with a single
+                                   polarity;
+    positive_literals,
+    negative_literals              occurrences of each polarity;
+    polarity_imbalance             mean of |p-n|/(p+n) over the used
+                                   variables, where p and n are their
+                                   positive and negative occurrences;
+    max_occurrences,
+    mean_occurrences               occurrences of the used variables;
+    occurrences                    number of variables with 1, 2-3,
+                                   4-7, ... occurrences, one entry for
+                                   each power of two;
+    cnf2kcnf                       size of the output of cnf2kcnf for
+                                   each splitting strategy (variables,
+                                   clauses, literals and memory).
+
+  With option -v there are also the arrays `positive` and `negative`
+  with the occurrences of each variable.
+*/
+
+// Preamble
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "cnftools.hh"
+#include "parallel.hh"
+
+using std::cin;
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::string;
+using std::vector;
+
+
+void usage(std::ostream &err,string programname) {
+  err<<"Usage: "<<programname<<" [-i <file> [-j <threads>]] [-k <width>] [-v]"<<endl<<endl;
+  err<<"   -i  read the formula from <file> instead of the standard input."<<endl;
+  err<<"       It is a dimacs or a binary cnf file, possibly compressed."<<endl;
+  err<<"   -j  number of threads used to scan the input file (0 means"<<endl;
+  err<<"       one per core, default 1)."<<endl;
+  err<<"   -k  width for the predicted size of cnf2kcnf (default 3)."<<endl;
+  err<<"   -v  also print the occurrences of each variable."<<endl;
+}
+
+
+// Memory taken by a `cnf` (see `cnf.hh`).
+static size_t cnf_memory(size_t clauses,size_t literals) {
+  return sizeof(literal)*literals + sizeof(size_t)*(clauses+1);
+}
+
+static void print_array(std::ostream& out,const cnf_statistics& s,bool positive) {
+  out<<"[";
+  for (variable v=1; v<=s.variables; ++v)
+    out<<(v>1 ? ", " : "")<<(positive ? s.positive(v) : s.negative(v));
+  out<<"]";
+}
+
+static void print_statistics(std::ostream& out,const cnf_statistics& s,
+                             size_t k,bool verbose) {
+
+  // variables
+  size_t   used {0}, pure {0};
+  uint64_t positive {0}, negative {0}, most {0};
+  double   imbalance {0};
+  vector<size_t> histogram {};
+  for (variable v=1; v<=s.variables; ++v) {
+    uint64_t p {s.positive(v)}, n {s.negative(v)};
+    positive += p;
+    negative += n;
+    if (p+n==0) continue;
+    ++used;
+    pure      += (p==0 || n==0);
+    most       = std::max(most,p+n);
+    imbalance += static_cast<double>(p>n ? p-n : n-p)/(p+n);
+    size_t bucket {0};
+    while ((p+n) >> (bucket+1)) ++bucket;
+    if (bucket>=histogram.size()) histogram.resize(bucket+1,0);
+    ++histogram[bucket];
+  }
+
+  out<<"{"<<endl;
+  out<<"  \"variables\": "<<s.variables<<","<<endl;
+  out<<"  \"clauses\": "<<s.clauses<<","<<endl;
+  out<<"  \"literals\": "<<s.literals<<","<<endl;
+  out<<"  \"memory_bytes\": "<<cnf_memory(s.clauses,s.literals)<<","<<endl;
+  out<<"  \"empty_clauses\": "<<(s.widths.empty() ? 0 : s.widths[0])<<","<<endl;
+  out<<"  \"units\": "<<s.units()<<","<<endl;
+  out<<"  \"binaries\": "<<s.binaries()<<","<<endl;
+  out<<"  \"max_width\": "<<s.max_width()<<","<<endl;
+  out<<"  \"mean_width\": "<<s.mean_width()<<","<<endl;
+  out<<"  \"widths\": {";
+  bool first {true};
+  for (size_t w=0; w<s.widths.size(); ++w) {
+    if (s.widths[w]==0) continue;
+    out<<(first ? "" : ", ")<<"\""<<w<<"\": "<<s.widths[w];
+    first = false;
+  }
+  out<<"},"<<endl;
+  out<<"  \"used_variables\": "<<used<<","<<endl;
+  out<<"  \"pure_variables\": "<<pure<<","<<endl;
+  out<<"  \"positive_literals\": "<<positive<<","<<endl;
+  out<<"  \"negative_literals\": "<<negative<<","<<endl;
+  out<<"  \"polarity_imbalance\": "<<(used==0 ? 0.0 : imbalance/used)<<","<<endl;
+  out<<"  \"max_occurrences\": "<<most<<","<<endl;
+  out<<"  \"mean_occurrences\": "<<(used==0 ? 0.0 : static_cast<double>(s.literals)/used)<<","<<endl;
+  out<<"  \"occurrences\": [";
+  for (size_t i=0; i<histogram.size(); ++i) out<<(i>0 ? ", " : "")<<histogram[i];
+  out<<"],"<<endl;
+
+  // prediction for cnf2kcnf
+  out<<"  \"cnf2kcnf\": {\"k\": "<<k;
+  for (auto strategy : {split_strategy::chain, split_strategy::tree}) {
+    auto size = kcnf_output_size(s,k,strategy);
+    out<<", \""<<(strategy==split_strategy::tree ? "tree" : "chain")<<"\": {"
+       <<"\"variables\": "<<size.variables
+       <<", \"clauses\": "<<size.clauses
+       <<", \"literals\": "<<size.literals
+       <<", \"memory_bytes\": "<<cnf_memory(size.clauses,size.literals)<<"}";
+  }
+  out<<"}";
+
+  if (verbose) {
+    out<<","<<endl<<"  \"positive\": ";
+    print_array(out,s,true);
+    out<<","<<endl<<"  \"negative\": ";
+    print_array(out,s,false);
+  }
+  out<<endl<<"}"<<endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+  string       input_file {};
+  size_t       k          {3};
+  int          width      {3};
+  unsigned int threads    {1};
+  bool         verbose    {false};
+
+  vector<string> cmdline(argv,argv+argc);
+  try {
+    for (size_t i=1; i<cmdline.size(); ++i) {
+      if (cmdline[i]=="-v") {
+        verbose = true;
+        continue;
+      }
+      if (i+1==cmdline.size()) throw std::invalid_argument{"missing value"};
+      if      (cmdline[i]=="-i") input_file = cmdline[++i];
+      else if (cmdline[i]=="-k") width      = std::stoi(cmdline[++i]);
+      else if (cmdline[i]=="-j") threads    = thread_option(cmdline[++i]);
+      else throw std::invalid_argument{"unknown option"};
+    }
+    if (width<3) throw std::out_of_range{"The target width must be 3 or more."};
+    k = static_cast<size_t>(width);
+  } catch(...) {
+    usage(cerr,cmdline[0]);
+    exit(-1);
+  }
+
+  cnf_statistics s;
+  try {
+    if (!input_file.empty())
+      s = load_statistics_file(input_file,threads);
+    else
+      s = read_statistics(cin);
+  } catch(const std::system_error& e) {
+    cerr<<"Cannot read the input file: "<<e.what()<<endl;
+    exit(-1);
+  } catch(const dimacs_bad_syntax& e) {
+    cerr<<"Error in parsing the dimacs input file."<<endl;
+    exit(-1);
+  } catch(const dimacs_truncated& e) {
+    cerr<<"Unexpected end of input."<<endl;
+    exit(-1);
+  } catch(const dimacs_bad_value& e) {
+    cerr<<"The CNF formula dimacs file is inconsistent."<<endl;
+    exit(-1);
+  } catch(const cnf_cache_invalid& e) {
+    cerr<<"Error in reading the binary cnf file: "<<e.what()<<endl;
+    exit(-1);
+  } catch(const compression_error& e) {
+    cerr<<"Error in decompressing the input: "<<e.what()<<endl;
+    exit(-1);
+  }
+
+  print_statistics(cout,s,k,verbose);
+  exit(0);
+}
@@ -13,73 +13,510 @@
 */
 
 // Preamble
+#include <algorithm>
 #include <cstdlib>
+#include <vector>
 
 #include "cnftools.hh"
+#include "dimacs_reader.hh"
+#include "dimacs_writer.hh"
+#include "mapped_file.hh"
+#include "parallel.hh"
 
 //
 // Utility for CNF manipulations
 //
 
-// convert a cnf with into an equisatisfiable k-cnf using extension
-// variables.
-cnf cnf2kcnf(const cnf& F,size_t k) {
-
+static void check_width(size_t k) {
   if (k<3) {
     throw std::invalid_argument{
       "it is not possible to convert a general cnf into a 2-CNF."};}
-  
-  variable extension {0};
-  
+}
+
+// convert a cnf with into an equisatisfiable k-cnf using extension
+// variables.
+template <typename Split>
+static cnf kcnf_transform(const cnf& F,size_t k) {
+
+  variable extension {F.variables_number()};
+
+  // the size of the output only depends on the widths of the clauses
+  kcnf_split_size total {0,0,0};
+  for(const auto& cla: F) {
+    auto size = Split::size(cla.size(),k);
+    total.clauses  += size.clauses;
+    total.literals += size.literals;
+  }
+
   cnf G {F.variables_number()};
- 
+  G.reserve(total.clauses,total.literals);
+
+  kcnf_split_buffer buffer {};
   for(const auto& cla: F) {
+    Split::split(cla,k,extension,
+                 [&G](clause_view c) { G.add_clause(c); },buffer);
+  }
+  G.update_variables(extension);
 
-    // small clauses are copied
-    if (cla.size()<=k) {
+  return G;
+}
 
-      G.add_clause(cla);
-      continue;
-      
-    } else  {
 
-      // clauses have k-2 original (less for the last one) variables
-      // plus an extension variable at the beginning and one at the
-      // end.  The first literal is the negation to the last of the
-      // previous clause.
-      clause tempclause {};
+// Parallel version of cnf2kcnf.
+//
+// F is cut in pieces of consecutive clauses with roughly the same
+// number of literals. A first parallel pass computes the size of the
+// encoding of each piece, then a prefix sum gives the first extension
+// variable of each piece. In the second parallel pass each piece is
+// transformed into its own formula, allocated with the exact size,
+// and finally the pieces are joined in order.
+template <typename Split>
+static cnf kcnf_transform(const cnf& F,size_t k,unsigned int threads) {
+
+  if (threads<=1) return kcnf_transform<Split>(F,k);
+
+  // pieces
+  size_t npieces = std::max<size_t>(1,std::min<size_t>(4*static_cast<size_t>(threads),F.size()));
+  size_t target  = (F.literals_number()+F.size())/npieces + 1;
+  std::vector<size_t> bounds {0};
+  size_t weight {0};
+  for(size_t i=0; i<F.size(); ++i) {
+    weight += F[i].size()+1;
+    if (weight>=target) {
+      bounds.push_back(i+1);
+      weight = 0;
+    }
+  }
+  if (bounds.back()!=F.size()) bounds.push_back(F.size());
+  npieces = bounds.size()-1;
+
+  // size of the encoding of each piece
+  std::vector<kcnf_split_size> sizes(npieces,{0,0,0});
+  parallel_for(npieces,threads,[&](size_t p) {
+      for(size_t i=bounds[p]; i<bounds[p+1]; ++i) {
+        auto size = Split::size(F[i].size(),k);
+        sizes[p].variables += size.variables;
+        sizes[p].clauses   += size.clauses;
+        sizes[p].literals  += size.literals;
+      }
+    });
+
+  // first extension variable of each piece
+  std::vector<variable> base(npieces+1,F.variables_number());
+  for(size_t p=0; p<npieces; ++p) base[p+1] = base[p] + sizes[p].variables;
+
+  // transformation
+  std::vector<cnf> pieces(npieces);
+  parallel_for(npieces,threads,[&](size_t p) {
+      cnf& G = pieces[p];
+      G = cnf{F.variables_number()};
+      G.reserve(sizes[p].clauses,sizes[p].literals);
+      variable extension {base[p]};
+      kcnf_split_buffer buffer {};
+      for(size_t i=bounds[p]; i<bounds[p+1]; ++i) {
+        Split::split(F[i],k,extension,
+                     [&G](clause_view c) { G.add_clause(c); },buffer);
+      }
+    });
+
+  cnf G {F.variables_number()};
+  size_t clauses {0}, literals {0};
+  for(const auto& s : sizes) {
+    clauses  += s.clauses;
+    literals += s.literals;
+  }
+  G.reserve(clauses,literals);
+  for(auto& piece : pieces) {
+    G.append(piece);
+    piece = cnf{};
+  }
+  G.update_variables(base[npieces]);
+
+  return G;
+}
+
+
+cnf cnf2kcnf(const cnf& F,size_t k,split_strategy strategy) {
+  return cnf2kcnf(F,k,1,strategy);
+}
+
+cnf cnf2kcnf(const cnf& F,size_t k,unsigned int threads,split_strategy strategy) {
+  check_width(k);
+  switch (strategy) {
+    case split_strategy::tree:
+      return kcnf_transform<tree_split>(F,k,threads);
+    default:
+      return kcnf_transform<chain_split>(F,k,threads);
+  }
+}
+
+
+template <typename Split>
+static kcnf_split_size kcnf_total_size(const cnf_statistics& s,size_t k) {
+  kcnf_split_size total {s.variables,0,0};
+  for (size_t w=0; w<s.widths.size(); ++w) {
+    if (s.widths[w]==0) continue;
+    auto size = Split::size(w,k);
+    total.variables += static_cast<variable>(s.widths[w]*size.variables);
+    total.clauses   += s.widths[w]*size.clauses;
+    total.literals  += s.widths[w]*size.literals;
+  }
+  return total;
+}
+
+kcnf_split_size kcnf_output_size(const cnf_statistics& s,size_t k,split_strategy strategy) {
+  check_width(k);
+  switch (strategy) {
+    case split_strategy::tree:
+      return kcnf_total_size<tree_split>(s,k);
+    default:
+      return kcnf_total_size<chain_split>(s,k);
+  }
+}
+
+
+// Extension variables of the groups defined by cnf2kcnf_factored. The
+// groups are stored one after the other, and found with an open
+// addressing hash table, at most half full. The slots keep the hash
+// values, so that most lookups read a single slot.
+class group_table {
+
+  private:
+
+    struct slot {
+      uint64_t hash;
+      size_t   index;
+    };
+
+    std::vector<literal>  literals;
+    std::vector<size_t>   offsets {0};
+    std::vector<variable> variables;
+    std::vector<slot>     slots;
+
+    static const size_t empty {SIZE_MAX};
+
+    static uint64_t hash(const literal* group,size_t size) {
+      uint64_t h {0x9E3779B97F4A7C15ULL ^ size};
+      for (size_t i=0; i<size; ++i) {
+        h = (h ^ static_cast<uint32_t>(group[i])) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 29;
+      }
+      return h;
+    }
+
+    void rehash() {
+      std::vector<slot> old(2*slots.size(),slot{0,empty});
+      old.swap(slots);
+      for (const auto& x : old) {
+        if (x.index==empty) continue;
+        size_t s = x.hash & (slots.size()-1);
+        while (slots[s].index!=empty) s = (s+1) & (slots.size()-1);
+        slots[s] = x;
+      }
+    }
+
+  public:
+
+    // room for `groups` groups of `size` literals in total
+    group_table(size_t groups,size_t size) : literals{}, variables{}, slots{} {
+      size_t capacity {16};
+      while (capacity < 2*groups) capacity *= 2;
+      slots.assign(capacity,slot{0,empty});
+      literals.reserve(size);
+      offsets.reserve(groups+1);
+      variables.reserve(groups);
+    }
+
+    // The variable of the group, which is sorted. If the group is
+    // new, it gets variable `fresh`.
+    variable find_or_add(const literal* group,size_t size,variable fresh) {
+      uint64_t h {hash(group,size)};
+      size_t   s {h & (slots.size()-1)};
+      while (slots[s].index!=empty) {
+        size_t i {slots[s].index};
+        if (slots[s].hash==h && offsets[i+1]-offsets[i]==size &&
+            std::equal(group,group+size,literals.begin()+offsets[i]))
+          return variables[i];
+        s = (s+1) & (slots.size()-1);
+      }
+      slots[s] = slot{h,variables.size()};
+      literals.insert(literals.end(),group,group+size);
+      offsets.push_back(literals.size());
+      variables.push_back(fresh);
+      if (2*variables.size() > slots.size()) rehash();
+      return fresh;
+    }
+};
+
+const size_t group_table::empty;
+
 
-      for(size_t i=0; i<cla.size(); ++i) {
+// The tree split of `tree_split`, where each group is first looked up
+// among the ones already defined.
+cnf cnf2kcnf_factored(const cnf& F,size_t k) {
 
-        // close previous clause and open a new one
-        if (i % (k-2)==0) {
+  check_width(k);
 
-          extension=G.add_variable();
-          tempclause.push_back(toliteral(extension, true));
-          G.add_clause(tempclause);
+  // the groups of the tree split are at most as many as its variables
+  kcnf_split_size most {0,0,0};
+  for (const auto& cla : F) {
+    auto size = tree_split::size(cla.size(),k);
+    most.variables += size.variables;
+    most.clauses   += size.clauses;
+    most.literals  += size.literals;
+  }
+
+  variable extension {F.variables_number()};
+  cnf G {F.variables_number()};
+  G.reserve(most.clauses,most.literals);
+  group_table defined {static_cast<size_t>(most.variables),
+                       most.literals-2*static_cast<size_t>(most.variables)};
+  clause items {};
+  clause node {};
+
+  for (const auto& cla : F) {
+
+    if (cla.size()<=k) {
+      G.add_clause(cla);
+      continue;
+    }
 
-          tempclause.resize(0);
-          tempclause.push_back(toliteral(extension, false));
+    items.assign(cla.begin(),cla.end());
+    size_t n = items.size();
+    while (n>k) {
+      size_t next {0};
+      for (size_t i=0; i<n; i+=k-1) {
+        size_t end = std::min(n,i+k-1);
+
+        if (end-i==1) {
+          items[next++] = items[i];
+          continue;
         }
-        
-        tempclause.push_back(cla[i]);
 
+        node.resize(1);
+        node.insert(node.end(),items.begin()+i,items.begin()+end);
+        std::sort(node.begin()+1,node.end());
+        variable y = defined.find_or_add(node.data()+1,node.size()-1,extension+1);
+        if (y>extension) {
+          extension = y;
+          node[0] = toliteral(y, false);
+          G.add_clause(node);
+        }
+        items[next++] = toliteral(y, true);
       }
+      n = next;
+    }
+    G.add_clause(clause_view{items.data(),items.data()+n});
+  }
+  G.update_variables(extension);
+
+  return G;
+}
+
+
+// Incremental transformation.
 
-      // close the open clause
-      extension=G.add_variable();
-      tempclause.push_back(toliteral(extension, true));
-      G.add_clause(tempclause);
-
-      // last clause is just a single extension literal
-      tempclause.resize(0);
-      tempclause.push_back(toliteral(extension, false));
-      G.add_clause(tempclause);
-      
-        
+kcnf_incremental::kcnf_incremental(size_t k,split_strategy strategy):
+  k{k},
+  strategy{strategy},
+  started{false},
+  original{0},
+  last{0},
+  renamed{} {
+  check_width(k);
+}
+
+
+variable kcnf_incremental::output_variable(variable v) const {
+  if (v<=0) return 0;
+  if (v<=original) return v;
+  size_t i = static_cast<size_t>(v-original-1);
+  return i<renamed.size() ? renamed[i] : 0;
+}
+
+
+// Transform the clauses of F from `first` to the end, with the
+// variables after `original` replaced by their output variables.
+template <typename Split>
+static cnf kcnf_delta(const cnf& F,size_t first,size_t k,variable original,
+                      std::vector<variable>& renamed,variable& last) {
+
+  kcnf_split_size total {0,0,0};
+  for (size_t i=first; i<F.size(); ++i) {
+    auto size = Split::size(F[i].size(),k);
+    total.clauses  += size.clauses;
+    total.literals += size.literals;
+  }
+
+  cnf G {};
+  G.reserve(total.clauses,total.literals);
+  auto add = [&G](clause_view c) { G.add_clause(c); };
+  kcnf_split_buffer buffer {};
+  clause c {};
+
+  for (size_t i=first; i<F.size(); ++i) {
+    clause_view cla {F[i]};
+
+    bool fresh {false};
+    for (literal lit : cla) fresh = fresh || abs(lit)>original;
+    if (!fresh) {
+      Split::split(cla,k,last,add,buffer);
+      continue;
+    }
+
+    c.assign(cla.begin(),cla.end());
+    for (literal& lit : c) {
+      variable v = abs(lit);
+      if (v<=original) continue;
+      size_t j = static_cast<size_t>(v-original-1);
+      if (j>=renamed.size()) renamed.resize(j+1,0);
+      if (renamed[j]==0) renamed[j] = ++last;
+      lit = toliteral(renamed[j], lit>0);
     }
-    
+    Split::split(c,k,last,add,buffer);
   }
+  G.update_variables(last);
+  return G;
+}
+
+
+cnf kcnf_incremental::translate(cnf& F) {
 
+  if (!started) {
+    started  = true;
+    original = F.variables_number();
+    last     = original;
+  }
+
+  cnf G {};
+  switch (strategy) {
+    case split_strategy::tree:
+      G = kcnf_delta<tree_split>(F,F.watermark(),k,original,renamed,last);
+      break;
+    default:
+      G = kcnf_delta<chain_split>(F,F.watermark(),k,original,renamed,last);
+  }
+  F.set_watermark();
   return G;
 }
+
+
+// Convert a dimacs file to k-cnf, without storing the formula. The
+// input is read twice, by two readers which start at its beginning.
+
+// first pass: validate the input and compute the size of the output
+template <typename Split>
+static void kcnf_stream_size(dimacs_reader& reader,size_t k,
+                             variable& outvars,size_t& outclauses) {
+  variable n {0};
+  cnf::size_type m {0};
+  clause c;
+
+  reader.read_spec(n,m);
+  outvars    = n;
+  outclauses = 0;
+  for (size_t i=0;i<m;++i) {
+    if (reader.read_clause(c) > n)
+      throw dimacs_bad_value{"Dimacs file contains clauses with invalid literals."};
+    auto size = Split::size(c.size(),k);
+    outvars    += size.variables;
+    outclauses += size.clauses;
+  }
+}
+
+// second pass: transform and print each clause
+template <typename Split>
+static void kcnf_stream_write(dimacs_reader& reader,size_t k,
+                              variable outvars,size_t outclauses,std::ostream& out) {
+  variable n {0};
+  cnf::size_type m {0};
+  clause c;
+
+  reader.read_spec(n,m);
+
+  variable extension {n};
+  dimacs_writer writer {out};
+  writer.write_spec(outvars,outclauses);
+  kcnf_split_buffer buffer {};
+  for (size_t i=0;i<m;++i) {
+    reader.read_clause(c);
+    Split::split(c,k,extension,
+                 [&writer](clause_view d) { writer.write_clause(d); },buffer);
+  }
+  writer.flush();
+}
+
+// Both passes on the dimacs formula in [begin,end).
+template <typename Split>
+static void kcnf_stream(const char* begin,const char* end,size_t k,std::ostream& out) {
+  variable outvars {0};
+  size_t outclauses {0};
+  {
+    dimacs_reader reader {begin,end};
+    kcnf_stream_size<Split>(reader,k,outvars,outclauses);
+  }
+  dimacs_reader reader {begin,end};
+  kcnf_stream_write<Split>(reader,k,outvars,outclauses,out);
+}
+
+// Both passes on compressed data, which is decompressed once for each
+// pass.
+template <typename Split>
+static void kcnf_stream(const char* begin,const char* end,compression format,
+                        size_t k,std::ostream& out) {
+  variable outvars {0};
+  size_t outclauses {0};
+  {
+    decompressing_istream in {begin,end,format};
+    if (in.peek()==static_cast<unsigned char>(cnf_cache_magic[0])) {
+      out<<kcnf_transform<Split>(read_cnf(in),k);
+      return;
+    }
+    dimacs_reader reader {in};
+    kcnf_stream_size<Split>(reader,k,outvars,outclauses);
+  }
+  decompressing_istream in {begin,end,format};
+  dimacs_reader reader {in};
+  kcnf_stream_write<Split>(reader,k,outvars,outclauses,out);
+}
+
+
+void cnf2kcnf_stream(const char* begin,const char* end,size_t k,std::ostream& out,
+                     split_strategy strategy) {
+
+  check_width(k);
+
+  // a binary cache is loaded with essentially a copy
+  if (is_cnf_cache(begin,end)) {
+    out<<cnf2kcnf(read_cnf_cache(begin,end),k,strategy);
+    return;
+  }
+
+  switch (strategy) {
+    case split_strategy::tree:
+      kcnf_stream<tree_split>(begin,end,k,out);
+      break;
+    default:
+      kcnf_stream<chain_split>(begin,end,k,out);
+  }
+}
+
+void cnf2kcnf_stream(const std::string& path,size_t k,std::ostream& out,
+                     split_strategy strategy) {
+  mapped_file file {path};
+
+  auto format = compression_by_magic(file.begin(),file.end());
+  if (format==compression::none) {
+    cnf2kcnf_stream(file.begin(),file.end(),k,out,strategy);
+    return;
+  }
+
+  check_width(k);
+  switch (strategy) {
+    case split_strategy::tree:
+      kcnf_stream<tree_split>(file.begin(),file.end(),format,k,out);
+      break;
+    default:
+      kcnf_stream<chain_split>(file.begin(),file.end(),format,k,out);
+  }
+}
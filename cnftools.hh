@@ -26,12 +26,300 @@
 #define _CNFTOOLS_HH_
 
 
-#include "cnf.hh"        // cnf data structure
-#include "dimacs_io.hh"  // cnf I/O in dimacs format.
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cnf.hh"            // cnf data structure
+#include "dimacs_io.hh"      // cnf I/O in dimacs format.
+#include "dimacs_reader.hh"  // dimacs tokenizer
+#include "dimacs_writer.hh"  // dimacs buffered output
+#include "cnf_cache.hh"      // binary cnf files
+#include "compression.hh"    // compressed files
+#include "cnfgen.hh"         // random formulas
+#include "simplify.hh"       // formula simplification
+#include "occurrences.hh"    // occurrence lists
+#include "statistics.hh"     // formula statistics
+#include "elimination.hh"    // variable elimination
+#include "propagation.hh"    // unit propagation
+#include "equivalences.hh"   // equivalent literals
+#include "components.hh"     // connected components
+#include "renumbering.hh"    // variable renumbering
 
 
 /* CNF manipulation tools */
-cnf cnf2kcnf(const cnf& F,size_t k);
+
+// Strategies to split the clauses wider than k (see below).
+enum class split_strategy { chain, tree };
+
+cnf cnf2kcnf(const cnf& F,size_t k,split_strategy strategy=split_strategy::chain);
+
+// Same as above, but the clauses of F are transformed on several
+// threads. The result is exactly the same formula: since the number of
+// extension variables needed by a clause only depends on its width,
+// the variables of each piece of F are known before the transformation
+// starts.
+cnf cnf2kcnf(const cnf& F,size_t k,unsigned int threads,
+             split_strategy strategy=split_strategy::chain);
+
+// Same as cnf2kcnf with the tree strategy, but the extension variables
+// are shared among clauses. Each extension variable y of the tree
+// split stands for a group of literals (or of other extension
+// variables), and it is only defined by the clause (¬y v group). When
+// the same group (as a set) occurs again, in the same clause or in
+// another one, the variable already defined is used, and no clause is
+// added. Clauses which share long subsequences of literals, e.g. the
+// same "at least one of" constraint with different side literals,
+// then share whole subtrees of their encodings. The result is
+// equisatisfiable to F, and it is computed on a single thread, since
+// the extension variables depend on the previous clauses.
+cnf cnf2kcnf_factored(const cnf& F,size_t k);
+
+// Convert the dimacs formula in [begin,end) into an equisatisfiable
+// k-cnf, and print it in dimacs format on `out`. The output is the
+// same as `out<<cnf2kcnf(parse_dimacs(...),k)`, but neither the input
+// nor the output formula is ever stored in memory: the input is
+// scanned twice, first to compute the size of the output and then to
+// transform and print it clause by clause. If the input is not a
+// correct dimacs file the parser exceptions are thrown before any
+// output is produced. A binary cache (see `cnf_cache.hh`) is accepted
+// too, and it is loaded in memory.
+void cnf2kcnf_stream(const char* begin,const char* end,size_t k,std::ostream& out,
+                     split_strategy strategy=split_strategy::chain);
+void cnf2kcnf_stream(const std::string& path,size_t k,std::ostream& out,
+                     split_strategy strategy=split_strategy::chain);
+
+
+// Incremental version of cnf2kcnf, for a formula which grows by
+// batches of clauses (see the watermark in `cnf.hh`).
+//
+//   kcnf_incremental T {3};
+//   cout<<T.translate(F);        // all clauses of F
+//   F.add_clause(...);
+//   cout<<T.translate(F);        // only the clauses just added
+//
+// Each call transforms the clauses of F from its watermark to the end,
+// moves the watermark to the end, and returns the encoding of those
+// clauses only, in time proportional to their size. The extension
+// variables continue the numbering of the previous calls, and the
+// returned formula has as many variables as the whole output so far.
+// The union of the results is an equisatisfiable k-cnf of F.
+//
+// The variables of F at the first call keep their index. A variable
+// which appears later may already be an extension variable, so it is
+// renamed to a new output variable (see `output_variable`).
+class kcnf_incremental {
+
+  private:
+
+    size_t k;
+    split_strategy strategy;
+    bool     started;
+    variable original;                 // variables of F at the first call
+    variable last;                     // last variable of the output
+    std::vector<variable> renamed;     // of variables original+1, ...
+
+  public:
+
+    kcnf_incremental(size_t k,split_strategy strategy=split_strategy::chain);
+
+    cnf translate(cnf& F);
+
+    // the output variable of variable `v` of F (0 if it has not
+    // occurred yet)
+    variable output_variable(variable v) const;
+
+    // number of variables of the output so far
+    variable variables_number() const { return last; }
+};
+
+
+/* Splitting of a single clause. */
+
+// Size of the encoding of a clause of width `w` made by cnf2kcnf:
+// number of extension variables, of clauses and of literals.
+struct kcnf_split_size {
+  variable  variables;
+  size_t    clauses;
+  size_t    literals;
+};
+
+// Working memory of the splitting functions. The same buffers can be
+// used for all the clauses of a formula, so that the transformation
+// does not allocate memory for each clause.
+struct kcnf_split_buffer {
+  clause items;
+  clause node;
+};
+
+// Each splitting strategy is a policy class with the static members
+//
+//   kcnf_split_size size(size_t w,size_t k);
+//   void split(clause_view cla,size_t k,variable& last,Emit emit,
+//              kcnf_split_buffer& buffer);
+//   void split(clause_view cla,size_t k,variable& last,Emit emit);
+//
+// where `split` transforms a single clause: extension variables are
+// numbered after `last`, which is updated, and each clause of the
+// encoding is passed to `emit` as a `clause_view`, which is valid
+// only during the call. Clauses of width at most k are passed on as
+// they are. The second form of `split` uses buffers of its own. The
+// transformations are templates on the policy, so the strategy is
+// chosen once for the whole formula.
+
+
+// Linear chain of extension variables y_1 ... y_t
+//
+//   y_1, (¬y_1 v x_1 ... x_{k-2} v y_2), ..., (¬y_{t-1} v ... v y_t), ¬y_t
+//
+// A clause of width w gives a chain of length about w/(k-2).
+struct chain_split {
+
+  static kcnf_split_size size(size_t w,size_t k) {
+    if (w<=k) return {0,1,w};
+    // a new extension variable every k-2 literals, plus the last one
+    auto t = static_cast<variable>((w+k-3)/(k-2) + 1);
+    return {t, static_cast<size_t>(t)+1, w + 2*static_cast<size_t>(t)};
+  }
+
+  template <typename Emit>
+  static void split(clause_view cla,size_t k,variable& last,Emit emit,
+                    kcnf_split_buffer& buffer) {
+
+    // small clauses are copied
+    if (cla.size()<=k) {
+      emit(cla);
+      return;
+    }
+
+    // clauses have k-2 original (less for the last one) variables
+    // plus an extension variable at the beginning and one at the
+    // end.  The first literal is the negation to the last of the
+    // previous clause.
+    clause& tempclause = buffer.node;
+    tempclause.resize(0);
+
+    for(size_t i=0; i<cla.size(); ++i) {
+
+      // close previous clause and open a new one
+      if (i % (k-2)==0) {
+
+        ++last;
+        tempclause.push_back(toliteral(last, true));
+        emit(clause_view{tempclause});
+
+        tempclause.resize(0);
+        tempclause.push_back(toliteral(last, false));
+      }
+
+      tempclause.push_back(cla[i]);
+
+    }
+
+    // close the open clause
+    ++last;
+    tempclause.push_back(toliteral(last, true));
+    emit(clause_view{tempclause});
+
+    // last clause is just a single extension literal
+    tempclause.resize(0);
+    tempclause.push_back(toliteral(last, false));
+    emit(clause_view{tempclause});
+  }
+
+  template <typename Emit>
+  static void split(clause_view cla,size_t k,variable& last,Emit emit) {
+    kcnf_split_buffer buffer {};
+    split(cla,k,last,emit,buffer);
+  }
+};
+
+
+// Balanced tree of extension variables. The literals are grouped k-1
+// at a time, and each group g gets a variable y with the clause
+//
+//   (¬y v g)
+//
+// then the variables are grouped in the same way, level by level,
+// until at most k of them are left, which form the last clause. A
+// clause of width w gives a tree of depth about log(w)/log(k-1), with
+// about as many variables and clauses as the chain.
+struct tree_split {
+
+  static kcnf_split_size size(size_t w,size_t k) {
+    if (w<=k) return {0,1,w};
+    size_t t {0};
+    for (size_t n=w; n>k; ) {
+      size_t groups = n/(k-1), rest = n%(k-1);
+      t += groups + (rest>=2);
+      n  = groups + (rest>0);
+    }
+    auto v = static_cast<variable>(t);
+    return {v, t+1, w + 2*t};
+  }
+
+  template <typename Emit>
+  static void split(clause_view cla,size_t k,variable& last,Emit emit,
+                    kcnf_split_buffer& buffer) {
+
+    if (cla.size()<=k) {
+      emit(cla);
+      return;
+    }
+
+    // the current level, written over the previous one
+    clause& items = buffer.items;
+    clause& node  = buffer.node;
+    items.assign(cla.begin(),cla.end());
+
+    size_t n = items.size();
+    while (n>k) {
+      size_t next {0};
+      for (size_t i=0; i<n; i+=k-1) {
+        size_t end = std::min(n,i+k-1);
+
+        // a group of one literal goes up unchanged
+        if (end-i==1) {
+          items[next++] = items[i];
+          continue;
+        }
+
+        ++last;
+        node.resize(0);
+        node.push_back(toliteral(last, false));
+        node.insert(node.end(),items.begin()+i,items.begin()+end);
+        emit(clause_view{node});
+        items[next++] = toliteral(last, true);
+      }
+      n = next;
+    }
+    emit(clause_view{items.data(),items.data()+n});
+  }
+
+  template <typename Emit>
+  static void split(clause_view cla,size_t k,variable& last,Emit emit) {
+    kcnf_split_buffer buffer {};
+    split(cla,k,last,emit,buffer);
+  }
+};
+
+
+// Size of the output of cnf2kcnf on a formula with statistics `s`
+// (see `statistics.hh`): variables, original ones included, clauses
+// and literals. It does not depend on the order of the clauses.
+kcnf_split_size kcnf_output_size(const cnf_statistics& s,size_t k,
+                                 split_strategy strategy=split_strategy::chain);
+
+
+// The default strategy, a chain.
+inline kcnf_split_size kcnf_split(size_t w,size_t k) {
+  return chain_split::size(w,k);
+}
+
+template <typename Emit>
+void kcnf_split_clause(clause_view cla,size_t k,variable& last,Emit emit) {
+  chain_split::split(cla,k,last,emit);
+}
 
 
 #endif /* _CNFTOOLS_HH_ */
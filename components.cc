@@ -0,0 +1,120 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 23:58 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 23:58 (CEST) Massimo Lauria"
+
+  Description::
+
+  Connected components of a CNF formula.
+
+  Implementation file: see the header file `components.hh` for actual
+  documentation.
+
+*/
+
+// Preamble
+#include <utility>
+
+#include "components.hh"
+
+using std::vector;
+
+
+// Code
+
+// Disjoint sets of the variables 1,...,n.
+class variable_sets {
+
+  private:
+
+    vector<variable> parent;
+    vector<variable> size;
+
+  public:
+
+    explicit variable_sets(variable n):
+      parent(static_cast<size_t>(n)+1),
+      size(static_cast<size_t>(n)+1,1) {
+      for (variable v=0; v<=n; ++v) parent[v] = v;
+    }
+
+    variable find(variable v) {
+      while (parent[v]!=v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+      }
+      return v;
+    }
+
+    void join(variable a,variable b) {
+      a = find(a);
+      b = find(b);
+      if (a==b) return;
+      if (size[a]<size[b]) std::swap(a,b);
+      parent[b] = a;
+      size[a]  += size[b];
+    }
+};
+
+
+vector<cnf_component> split_components(const cnf& F) {
+  variable n {F.variables_number()};
+
+  variable_sets sets {n};
+  vector<bool> used(static_cast<size_t>(n)+1,false);
+  bool empty_clauses {false};
+  for (auto c : F) {
+    empty_clauses = empty_clauses || c.empty();
+    for (literal lit : c) {
+      used[abs(lit)] = true;
+      sets.join(abs(c[0]),abs(lit));
+    }
+  }
+
+  // number the components by their smallest variable, and the
+  // variables inside each component
+  const size_t none {static_cast<size_t>(-1)};
+  vector<size_t>   component_of(static_cast<size_t>(n)+1,none);  // by root
+  vector<variable> renamed(static_cast<size_t>(n)+1,0);
+  vector<cnf_component> result {};
+  for (variable v=1; v<=n; ++v) {
+    if (!used[v]) continue;
+    variable root {sets.find(v)};
+    if (component_of[root]==none) {
+      component_of[root] = result.size();
+      result.push_back({cnf{},{}});
+    }
+    auto& C = result[component_of[root]];
+    C.variables.push_back(v);
+    renamed[v] = static_cast<variable>(C.variables.size());
+  }
+  if (empty_clauses) result.push_back({cnf{},{}});
+
+  // size of each component, then its clauses
+  vector<size_t> clauses(result.size(),0), literals(result.size(),0);
+  for (auto c : F) {
+    size_t i {c.empty() ? result.size()-1 : component_of[sets.find(abs(c[0]))]};
+    ++clauses[i];
+    literals[i] += c.size();
+  }
+  for (size_t i=0; i<result.size(); ++i) {
+    result[i].formula = cnf{static_cast<variable>(result[i].variables.size())};
+    result[i].formula.reserve(clauses[i],literals[i]);
+  }
+
+  clause renumbered {};
+  for (auto c : F) {
+    size_t i {c.empty() ? result.size()-1 : component_of[sets.find(abs(c[0]))]};
+    renumbered.resize(0);
+    for (literal lit : c) renumbered.push_back(lit>0 ? renamed[lit] : -renamed[-lit]);
+    result[i].formula.add_clause(renumbered);
+  }
+  return result;
+}
+
+
+void write_variable_map(std::ostream& out,const vector<variable>& variables) {
+  for (size_t j=0; j<variables.size(); ++j)
+    out<<(j+1)<<" "<<variables[j]<<"\n";
+}
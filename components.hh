@@ -0,0 +1,61 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 23:58 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 23:58 (CEST) Massimo Lauria"
+
+  Description::
+
+  Connected components of a CNF formula.
+
+  Two variables are connected if they occur in the same clause, and a
+  component is a maximal set of connected variables with their
+  clauses. Components share no variables, hence the formula is
+  satisfiable if and only if each component is, and they can be
+  processed (or solved) separately.
+
+     for (auto& C : split_components(F)) {
+       C.formula;       // on variables 1,...,C.variables.size()
+       C.variables;     // variable j of C.formula is C.variables[j-1] in F
+     }
+
+  Each component is numbered compactly: its variables keep their
+  relative order and get numbers 1,2,... Components are ordered by
+  their smallest variable, and the clauses of each component keep
+  their relative order. Variables which do not occur in F are in no
+  component. The empty clauses, if any, form a last component with no
+  variables.
+
+  The correspondence between the variables of a component and the
+  ones of F is saved as text, one line "j v" for each variable j of
+  the component, with `write_variable_map`. A model of the component
+  is translated back by giving to v the value of j.
+
+  Implementation note: the components are found by a union-find on
+  the variables (union by size, with path halving) during a single
+  pass over the clauses, which joins the variables of each clause.
+  A second pass distributes the clauses. Both take linear time, up to
+  the inverse Ackermann factor of the union-find.
+*/
+
+#ifndef _COMPONENTS_HH_
+#define _COMPONENTS_HH_
+
+#include <ostream>
+#include <vector>
+
+#include "cnf.hh"
+
+
+struct cnf_component {
+  cnf formula;
+  std::vector<variable> variables;
+};
+
+std::vector<cnf_component> split_components(const cnf& F);
+
+// Print the line "j v" for each variable j, where v is `variables[j-1]`.
+void write_variable_map(std::ostream& out,const std::vector<variable>& variables);
+
+
+#endif /* _COMPONENTS_HH_ */
@@ -0,0 +1,198 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 17:40 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 17:40 (CEST) Massimo Lauria"
+
+  Description::
+
+  Compressed input and output streams.
+
+  Benchmark formulas are usually distributed compressed, e.g. as
+  `formula.cnf.gz` or `formula.cnf.xz`. The classes here read and write
+  such files as ordinary iostreams, so that the dimacs tokenizer and
+  the dimacs writer work on them unchanged.
+
+     decompressing_istream in {file.begin(), file.end(), compression::gzip};
+     cnf F {parse_dimacs(in)};
+
+     compressed_ofstream out {"formula.cnf.xz"};
+     out<<F;
+     out.close();
+
+  The supported formats are gzip (zlib), xz (liblzma) and zstd
+  (libzstd). Each of them is available only if the library has been
+  found at compile time, see `compression_supported`. Using a format
+  which is not supported throws a `compression_error`.
+
+  The format of compressed input is detected from its first bytes
+  (`compression_by_magic`). The format of compressed output is chosen
+  from the extension of the file name (`compression_by_extension`):
+  `.gz`, `.xz` and `.zst`. Any other name gives an uncompressed file.
+
+  A `decompressing_istream` decompresses the data on a separate
+  thread, in blocks of 1 MiB, a few blocks ahead of the reader, so
+  that decompression and parsing overlap. The compressed data is
+  either in memory (e.g. a mapped file) or read from another stream.
+
+  Compressed output is written in blocks by the thread which writes
+  to the stream. The compressed stream is terminated by `close()`,
+  which must be called to detect write errors (the destructor closes
+  the stream too, but ignores errors).
+
+  Corrupted or truncated compressed data causes a `compression_error`
+  to be thrown by the read operation which needs the missing data.
+*/
+
+#ifndef _COMPRESSION_HH_
+#define _COMPRESSION_HH_
+
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+enum class compression { none, gzip, xz, zstd };
+
+// Whether the library has been compiled with support for `format`.
+bool compression_supported(compression format);
+
+// Format of the data in [begin,end), from its first bytes.
+compression compression_by_magic(const char* begin,const char* end);
+
+// Format of the data in a stream, from its first byte, which is not
+// extracted.
+compression compression_by_magic(std::istream& in);
+
+// Format of a file, from the extension of its name.
+compression compression_by_extension(const std::string& path);
+
+
+class decoder;
+class encoder;
+
+
+// Stream buffer which decompresses data on a separate thread.
+class decompressing_buffer : public std::streambuf {
+
+  private:
+
+    std::unique_ptr<decoder> codec;
+    const char* in_pos;                 // compressed data not yet decoded
+    const char* in_end;
+    std::istream* source;               // source of more compressed data
+    std::vector<char> input;
+
+    // blocks of decompressed data, used as a ring
+    std::vector<std::vector<char>> blocks;
+    std::vector<size_t> filled;
+    size_t ready;                       // blocks filled and not yet released
+    size_t next_fill;
+    size_t next_read;
+    bool reading;                       // the get area is blocks[next_read]
+    bool finished;                      // no more blocks will be filled
+    bool stop;
+    std::exception_ptr error;
+
+    std::mutex lock;
+    std::condition_variable block_ready;
+    std::condition_variable block_free;
+    std::thread worker;
+
+    void produce();
+    size_t decompress(char* out,size_t size);
+
+  protected:
+
+    int_type underflow() override;
+
+  public:
+
+    static const size_t block_size {1<<20};
+    static const size_t block_number {4};
+
+    decompressing_buffer(const char* begin,const char* end,compression format);
+    decompressing_buffer(std::istream& source,compression format);
+    ~decompressing_buffer();
+};
+
+
+// Stream buffer which compresses data into another stream.
+class compressing_buffer : public std::streambuf {
+
+  private:
+
+    std::unique_ptr<encoder> codec;
+    std::ostream& sink;
+    std::vector<char> buffer;
+    bool finished;
+
+    void compress(bool finish);
+
+  protected:
+
+    int_type overflow(int_type c) override;
+    int sync() override;
+
+  public:
+
+    static const size_t block_size {1<<20};
+
+    compressing_buffer(std::ostream& sink,compression format);
+    ~compressing_buffer();
+
+    // terminate the compressed stream
+    void finish();
+};
+
+
+// Input stream of decompressed data. Errors in the compressed data
+// throw `compression_error` from the read operations.
+class decompressing_istream : public std::istream {
+
+  private:
+
+    decompressing_buffer buffer;
+
+  public:
+
+    decompressing_istream(const char* begin,const char* end,compression format);
+    decompressing_istream(std::istream& source,compression format);
+};
+
+
+// Output file, compressed according to the extension of its name.
+class compressed_ofstream : public std::ostream {
+
+  private:
+
+    std::ofstream file;
+    std::unique_ptr<compressing_buffer> buffer;
+
+  public:
+
+    explicit compressed_ofstream(const std::string& path);
+    compressed_ofstream(const std::string& path,compression format);
+    ~compressed_ofstream();
+
+    // Terminate the compressed stream and close the file. It throws
+    // `std::system_error` if the file could not be written.
+    void close();
+};
+
+
+// Errors in compressed data
+class compression_error : public std::runtime_error {
+  public:
+    compression_error(const std::string& data) : std::runtime_error{data} {}
+};
+
+
+#endif /* _COMPRESSION_HH_ */
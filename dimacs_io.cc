@@ -15,49 +15,31 @@
 
 // Preamble
 #include "cnf.hh"
+#include "compression.hh"
 #include "dimacs_io.hh"
+#include "dimacs_reader.hh"
+#include "dimacs_writer.hh"
+#include "mapped_file.hh"
+#include "parallel.hh"
 
 // 
+#include <algorithm>
+#include <exception>
 #include <iostream>
-#include <sstream>
-#include <locale>
+#include <vector>
 
 using std::string;
 using std::istream;
-using std::stringstream;
 using std::ostream;
 using std::endl;
-using std::isdigit;
+using std::vector;
 
 
 // Code
 
-// standard input/output iostream operator for clauses, implemented
-// for internal use only.
-//
-// if the clause in input is bad formatted, or the input ends
-// unexpectedly an exception is thrown. The parser should propagate it
-// upward.
-
-static istream& operator>>(istream &in,clause& c) {
-
-  literal tmp {null_literal};
-  bool    endofclause {false};
-
-  c.resize(0);
-
-  while(in >> tmp) {
-    if (tmp == null_literal) {endofclause=true; break; }
-    c.push_back(tmp);
-  }
+// standard output iostream operator for clauses.
 
-  if (in.eof() && !endofclause) throw dimacs_truncated{"Unexpected end of clause."};
-  if (in.fail()) throw dimacs_bad_syntax{"Bad clause specification in input."};
-
-  return in;
-}
-
-static ostream& operator<<(ostream &out,const clause& c) {
+ostream& operator<<(ostream &out,clause_view c) {
   if (c.size()>0) out<<c[0];
   for (unsigned int i=1; i < c.size(); ++i) {
     out<<" "<<c[i];
@@ -71,10 +53,9 @@ static ostream& operator<<(ostream &out,const clause& c) {
 // the cnf is printed and read in dimacs format.
 
 ostream& operator<<(ostream &out,const cnf& formula) {
-  out<<"p cnf "<<formula.variables_number()<<" "<<formula.size()<<endl;
-  for (auto c : formula) {
-    out<<c<<" 0"<<endl;
-  }
+  dimacs_writer writer {out};
+  writer.write(formula);
+  writer.flush();
   return out;
 }
 
@@ -86,90 +67,134 @@ istream& operator>>(istream &in,cnf& formula) {
 
 
 
-// Utility function for testing characters in string
-static bool only_spaces(const string& data) {
-  for (const auto c:data) {
-    if (!isspace(c)) return false;
-  }
-  return true;
-}
-
-
-static bool only_digits(const string& data) {
-  for(const auto c: data) {
-    if (!isdigit(c)) return false;
-  } 
-  return true;
-}
-
-
 /* Parse a dimacs file given as an input stream */
 cnf parse_dimacs(istream &in) {
-  
-  string buffer {};
-
-  // looks for the cnf specification line, and ignore comments and
-  // empty lines preceding it.
-  while(true) {
-    getline(in,buffer);
+  dimacs_reader reader {in};
+  return parse_dimacs(reader);
+}
 
-    if (buffer[0]=='c' || only_spaces(buffer))
-      continue;
+/* parse a cnf in dimacs format directly from a string */
+cnf parse_dimacs(const string &data) {
+  dimacs_reader reader {data.data(), data.data()+data.size()};
+  return parse_dimacs(reader);
+}
 
-    else if (buffer[0]=='p')
-      break;     
+/* parse a cnf in dimacs format from a file mapped in memory */
+cnf parse_dimacs_file(const string &path,unsigned int threads) {
+  mapped_file file {path};
 
-    else
-      throw dimacs_bad_syntax{"non comment line before cnf specification."};
+  // compressed files are parsed while they are decompressed
+  auto format = compression_by_magic(file.begin(),file.end());
+  if (format!=compression::none) {
+    decompressing_istream in {file.begin(),file.end(),format};
+    return parse_dimacs(in);
   }
+  return parse_dimacs(file.begin(),file.end(),threads);
+}
 
-  // parse the specification line of the form 'p cnf n m'
-  stringstream specline{buffer};
+/* parse a cnf in dimacs format from a string, using several threads */
+cnf parse_dimacs(const string &data,unsigned int threads) {
+  return parse_dimacs(data.data(),data.data()+data.size(),threads);
+}
 
-  string s_p   {};
-  string s_cnf {};
-  string s_n   {};
-  string s_m   {};
-  
-  variable n {0};        // variable number
-  cnf::size_type m {0};  // clause number 
+// Read the `m` clauses of a formula on `n` variables.
+static cnf read_clauses(dimacs_reader &reader,variable n,cnf::size_type m) {
 
-  specline>>s_p>>s_cnf>>s_n>>s_m; // parse the spec line
-  
-  if (specline.fail() ||
-      s_p!="p" || s_cnf!="cnf" ||
-      !only_digits(s_n) || !only_digits(s_m)) {
-    throw dimacs_bad_syntax{"Bad specification line: \"p  cnf  <nvars> <nclauses>\" expected."};
-  } 
-
-  // we verified that s_n and s_m are sequence of just digits, so they
-  // represent positive integers. We need to do this passage
-  // explicitly because C++ standard I/O system do not check if signed
-  // integer is read into an unsigned integer.
-  (stringstream {s_n})>>n;
-  (stringstream {s_m})>>m;
-
-  specline>>s_p;
-  if (!specline.eof())
-    throw dimacs_bad_syntax{"Running characters in the specification line."};
-  
-  // read clauses
+  // When the input is in memory the clause index is allocated in
+  // advance, unless the spec line claims more clauses than the input
+  // can contain.
   cnf    formula {n};
   clause c;
+  formula.reserve(std::min(m,reader.memory_left()/2),0);
+
   for (size_t i=0;i<m;++i) {
-    in >> c;
-    formula.add_clause(c);
-    if (formula.variables_number() > n)
+    if (reader.read_clause(c) > n)
       throw dimacs_bad_value{"Dimacs file contains clauses with invalid literals."};
+    formula.add_clause(c);
   }
-  
+
   return formula;
 }
 
-/* parse a cnf in dimacs format directly from a string */
-cnf parse_dimacs(const string &data) {
-  stringstream inputdata {data};
-  return parse_dimacs(inputdata);
+/* Parse a dimacs file from a tokenizer */
+cnf parse_dimacs(dimacs_reader &reader) {
+
+  variable n {0};        // variable number
+  cnf::size_type m {0};  // clause number
+
+  reader.read_spec(n,m);
+  return read_clauses(reader,n,m);
+}
+
+
+// Clauses to reserve for a piece of `piece` bytes of a body of `body`
+// bytes with m clauses: its share of m, with some slack, and never
+// more than m or than the clauses which fit in the piece.
+static size_t piece_clauses(size_t m,size_t piece,size_t body) {
+  double share = static_cast<double>(m)*piece/std::max<size_t>(body,1);
+  size_t guess = static_cast<size_t>(share*1.125)+16;
+  return std::min({guess,m,piece/dimacs_min_clause});
 }
 
 
+/* Parse a dimacs file in memory, using several threads.
+
+   The body of the file after the spec line is cut in one piece per
+   thread, at clause boundaries. Each piece is parsed independently,
+   and the clauses are concatenated in order. A parsing error in
+   a piece is reported only if the sequential parser would have met
+   it, i.e. if it occurs before the m-th clause of the formula.
+*/
+cnf parse_dimacs(const char* begin,const char* end,unsigned int threads) {
+
+  variable n {0};
+  cnf::size_type m {0};
+
+  dimacs_reader reader {begin,end};
+  reader.read_spec(n,m);
+
+  // cut the body
+  const char* body = reader.position();
+  vector<const char*> bounds {dimacs_pieces(body,end,threads)};
+  threads = static_cast<unsigned int>(bounds.size()-1);
+  if (threads<=1) return read_clauses(reader,n,m);
+
+  // parse the pieces
+  struct piece {
+    cnf formula;
+    std::exception_ptr error;   // raised after the last clause in `formula`
+  };
+  vector<piece> pieces(threads);
+
+  parallel_for(threads,threads,[&](size_t i) {
+      dimacs_reader chunk {bounds[i],bounds[i+1]};
+      cnf&   formula = pieces[i].formula;
+      clause c;
+      formula = cnf{n};
+      formula.reserve(piece_clauses(m,bounds[i+1]-bounds[i],end-body),0);
+      try {
+        while (!chunk.at_end()) {
+          if (chunk.read_clause(c) > n)
+            throw dimacs_bad_value{"Dimacs file contains clauses with invalid literals."};
+          formula.add_clause(c);
+        }
+      } catch(...) {
+        pieces[i].error = std::current_exception();
+      }
+    });
+
+  // concatenate
+  cnf formula {std::move(pieces[0].formula)};
+  formula.truncate(m);
+  if (formula.size()==m) return formula;
+  if (pieces[0].error) std::rethrow_exception(pieces[0].error);
+
+  for(unsigned int i=1; i<threads; ++i) {
+    formula.append(pieces[i].formula,m-formula.size());
+    pieces[i].formula = cnf{};
+    if (formula.size()==m) return formula;
+    if (pieces[i].error) std::rethrow_exception(pieces[i].error);
+  }
+
+  throw dimacs_truncated{"Unexpected end of clause."};
+}
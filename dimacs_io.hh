@@ -13,7 +13,8 @@
 
   E.g. if F is a cnf object, `cin>>F` parses a dimacs file given to
   the standard input and copies into the object F. To print it back in
-  dimacs format just use `cout<<F`
+  dimacs format just use `cout<<F`, which goes through the buffered
+  writer of `dimacs_writer.hh`.
   
   Alteratively a `cnf` object is returned by the `parse_dimacs`
   function, which parse either an input stream or and string.
@@ -33,6 +34,37 @@
   only difference is that `parse_dimacs` can be used for variable
   initialization.
 
+  Parsing is done by the tokenizer in `dimacs_reader.hh`, which scans
+  the raw bytes of the input. A string is parsed in place, while an
+  input stream is read in large blocks, hence the stream may be
+  consumed beyond the end of the formula.
+
+  The fastest way to read a formula stored in a file is
+
+     parse_dimacs_file("formula.cnf");
+
+  which maps the file in memory and parses it in place (see
+  `mapped_file.hh`). If the file cannot be read, a `std::system_error`
+  is thrown.
+
+  Formulas in memory (files or strings) can be parsed with several
+  threads, e.g.
+
+     parse_dimacs_file("formula.cnf",8);
+
+  The part of the file after the spec line is cut in pieces at clause
+  boundaries, the pieces are parsed at the same time and then joined.
+  The number of pieces is capped (see `dimacs_pieces` in
+  `dimacs_reader.hh`), whatever the number of threads requested. The
+  result, and the exception thrown on bad input, are the same as with
+  a single thread. During the join the clauses of the pieces and the
+  formula are in memory together.
+
+  A file compressed with gzip, xz or zstd is detected by
+  `parse_dimacs_file`, and it is decompressed on a separate thread
+  while it is parsed (see `compression.hh`). Compressed files are
+  always parsed by a single thread.
+
   DIMACS PARSING
   
   A dimacs file is a cnf representation of the following form:
@@ -84,9 +116,23 @@
 std::istream& operator>>(std::istream &in,cnf& formula);
 std::ostream& operator<<(std::ostream &out,const cnf& formula);
 
+// print the literals of a clause, separated by spaces (the clause
+// terminator is not printed).
+std::ostream& operator<<(std::ostream &out,clause_view c);
+
+class dimacs_reader;
+
 // Parse a CNF from a dimacs file, from input stream or from text.
 cnf parse_dimacs(std::istream &in);
 cnf parse_dimacs(const std::string &data);
+cnf parse_dimacs(dimacs_reader &reader);
+
+// Parse a CNF from the dimacs file at `path`, which is memory mapped.
+cnf parse_dimacs_file(const std::string &path,unsigned int threads=1);
+
+// Parse a CNF from a dimacs file in memory using several threads.
+cnf parse_dimacs(const char* begin,const char* end,unsigned int threads);
+cnf parse_dimacs(const std::string &data,unsigned int threads);
 
 
 // Parser exceptions
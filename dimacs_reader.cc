@@ -0,0 +1,563 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 10:12 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 10:12 (CEST) Massimo Lauria"
+
+  Description::
+
+  Tokenizer for dimacs files, working on raw byte buffers.
+
+  Implementation file: see the header file `dimacs_reader.hh` for
+  actual documentation.
+
+*/
+
+// Preamble
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "dimacs_reader.hh"
+#include "dimacs_io.hh"
+#include "parallel.hh"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define DIMACS_SWAR_SCAN 1
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DIMACS_SIMD_SCAN 1
+#include <immintrin.h>
+#endif
+#endif
+
+using std::string;
+using std::istream;
+
+
+// Code
+
+// Character classification. Spaces are the ones of `isspace` in the
+// "C" locale, and the table avoids any locale dependent call in the
+// scanner loops.
+static const struct space_table {
+  bool value[256];
+  space_table() : value{} {
+    for (const char c : {' ','\t','\n','\v','\f','\r'})
+      value[static_cast<unsigned char>(c)] = true;
+  }
+} spaces {};
+
+static inline bool is_space(int c) { return spaces.value[c]; }
+
+static inline bool is_digit(int c) {
+  return static_cast<unsigned int>(c-'0') < 10;
+}
+
+
+// Choice of the fast path
+
+bool dimacs_scanner_supported(dimacs_scanner s) {
+  switch (s) {
+#ifdef DIMACS_SIMD_SCAN
+    case dimacs_scanner::sse2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse2");
+    case dimacs_scanner::avx2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+#endif
+    case dimacs_scanner::scalar:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static dimacs_scanner best_scanner() {
+  for (auto s : {dimacs_scanner::avx2, dimacs_scanner::sse2})
+    if (dimacs_scanner_supported(s)) return s;
+  return dimacs_scanner::scalar;
+}
+
+// the scanner of new readers, chosen at the first use
+static std::atomic<int> active_scanner {-1};
+
+dimacs_scanner dimacs_active_scanner() {
+  int s = active_scanner.load(std::memory_order_relaxed);
+  if (s<0) {
+    s = static_cast<int>(best_scanner());
+    active_scanner.store(s,std::memory_order_relaxed);
+  }
+  return static_cast<dimacs_scanner>(s);
+}
+
+void dimacs_set_scanner(dimacs_scanner s) {
+  if (!dimacs_scanner_supported(s))
+    throw std::invalid_argument{"The dimacs scanner is not supported on this machine."};
+  active_scanner.store(static_cast<int>(s),std::memory_order_relaxed);
+}
+
+
+dimacs_reader::dimacs_reader(const char* begin, const char* end):
+  pos{begin},
+  end{end},
+  in{nullptr},
+  buffer{},
+  scanner{dimacs_active_scanner()} {}
+
+dimacs_reader::dimacs_reader(istream& in, size_t buffer_size):
+  pos{nullptr},
+  end{nullptr},
+  in{&in},
+  buffer(std::max(buffer_size,size_t{1})),
+  scanner{dimacs_active_scanner()} {}
+
+
+// Read the next block from the input stream, if any. The characters
+// in [pos,end) are kept at the beginning of the buffer, so that a
+// token which spans two blocks can be scanned again from its start.
+bool dimacs_reader::refill() {
+  if (in==nullptr) return false;
+
+  // a token as large as the buffer: make room for more data
+  size_t kept = end - pos;
+  if (kept==buffer.size()) {
+    size_t offset = pos - buffer.data();
+    buffer.resize(2*buffer.size());
+    pos = buffer.data() + offset;
+    end = pos + kept;
+  }
+  std::copy(pos,end,buffer.data());
+
+  in->read(buffer.data()+kept,buffer.size()-kept);
+  auto length = in->gcount();
+
+  pos = buffer.data();
+  end = pos + kept + (length>0 ? length : 0);
+  return length>0;
+}
+
+// skip spaces, and return the first non space character (or EOF)
+int dimacs_reader::skip_spaces() {
+  do {
+    const char* p = pos;
+    while (p<end && is_space(static_cast<unsigned char>(*p))) ++p;
+    pos = p;
+    if (p<end) return static_cast<unsigned char>(*p);
+  } while (refill());
+  return EOF;
+}
+
+// skip the rest of the current line, newline included
+void dimacs_reader::skip_line() {
+  do {
+    const char* p = pos;
+    while (p<end && *p!='\n') ++p;
+    pos = p;
+    if (p<end) {
+      ++pos;
+      return;
+    }
+  } while (refill());
+}
+
+// read a sequence of non space characters in the current line.
+// Spaces before it are skipped, and the result is empty if the line
+// (or the input) ends first.
+string dimacs_reader::read_word() {
+  string word {};
+  int c = peek();
+  while (c!=EOF && c!='\n' && is_space(c)) {
+    ++pos;
+    c = peek();
+  }
+  while (c!=EOF && !is_space(c)) {
+    word.push_back(static_cast<char>(c));
+    ++pos;
+    c = peek();
+  }
+  return word;
+}
+
+
+// Scan an integer literal at the current position, which must not be
+// a space. The literal must be followed by a space or by the end of
+// the input, and its absolute value must fit in a `literal`.
+//
+// The scan works on the characters available in the buffer. If the
+// token may continue past them, the buffer is refilled and the token
+// is scanned again.
+literal dimacs_reader::read_literal() {
+
+  const char* p;
+  bool negative;
+  uint64_t value;
+  size_t length;
+
+  do {
+    p        = pos;
+    negative = false;
+    value    = 0;
+
+    if (*p=='-' || *p=='+') {
+      negative = (*p=='-');
+      ++p;
+    }
+
+    const char* digits = p;
+    while (p<end) {
+      auto digit = static_cast<unsigned int>(*p-'0');
+      if (digit>9) break;
+      value = value*10 + digit;
+      if (value > INT_MAX)
+        throw dimacs_bad_syntax{"Bad clause specification in input."};
+      ++p;
+    }
+
+    length = p - pos;
+    if (p<end) {
+      if (p==digits || !is_space(static_cast<unsigned char>(*p)))
+        throw dimacs_bad_syntax{"Bad clause specification in input."};
+      break;
+    }
+
+    // end of the buffer: the token may be incomplete. The refill moves
+    // the token to the beginning of the buffer, even at end of input.
+  } while (refill());
+  p = pos + length;
+
+  // the input ends right after a sign
+  if (length==1 && (*pos=='-' || *pos=='+'))
+    throw dimacs_truncated{"Unexpected end of clause."};
+
+  pos = p;
+  return negative ? -static_cast<literal>(value) : static_cast<literal>(value);
+}
+
+
+// Append the literal of variable `value` to a clause, in its encoding.
+static inline void push_literal(clause& c,literal value,bool negative) {
+  c.push_back(negative ? -value : value);
+}
+
+static inline void push_literal(packed_clause& c,literal value,bool negative) {
+  c.push_back(packed_literal{value,!negative});
+}
+
+
+// Branch-light scanning of short numbers. Eight characters are loaded
+// in a 64-bit word (first character in the lowest byte), the length
+// of the leading run of digits is computed with bitwise arithmetic,
+// and the digits are converted with three multiplications.
+#ifdef DIMACS_SWAR_SCAN
+
+static inline unsigned int digits_length(uint64_t chunk) {
+  const uint64_t high = 0xF0F0F0F0F0F0F0F0ULL;
+  const uint64_t zero = 0x3030303030303030ULL;
+  // a byte is non zero iff the corresponding character is not a digit
+  uint64_t nondigit = ((chunk & high) ^ zero) |
+                      (((chunk + 0x0606060606060606ULL) & high) ^ zero);
+  // move the information to the top bit of each byte
+  nondigit = (((nondigit & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL) | nondigit)
+             & 0x8080808080808080ULL;
+  return nondigit==0 ? 8 : __builtin_ctzll(nondigit) / 8;
+}
+
+// value of the first `length` characters of chunk, which are digits
+// (0 < length < 8)
+static inline uint64_t digits_value(uint64_t chunk, unsigned int length) {
+  chunk = (chunk - 0x3030303030303030ULL) << (8*(8-length));
+  chunk = (chunk * 10) + (chunk >> 8);
+  chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+           (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+  return chunk;
+}
+
+
+// The fast paths scan the literals at `pos` as long as they have less
+// than 8 digits, they are followed by a space, and they are far from
+// the end of the buffer. They return true after reading the zero which
+// ends the clause; otherwise the rest of the clause is left to the
+// general code. In both cases `pos` is moved after the literals
+// scanned.
+
+// Scalar path: spaces are skipped one at a time, and each literal is
+// measured and converted on a 64-bit word.
+template <typename Clause>
+static inline bool scan_scalar(const char*& pos,const char* end,Clause& c,variable& maxvar) {
+  const char* p = pos;
+  while (true) {
+    while (p<end && is_space(static_cast<unsigned char>(*p))) ++p;
+    if (end-p < 10) break;
+
+    bool negative = (*p=='-');
+    const char* digits = p + (negative || *p=='+');
+    uint64_t chunk;
+    std::memcpy(&chunk,digits,sizeof(chunk));
+
+    unsigned int length = digits_length(chunk);
+    if (length==0 || length==8 ||
+        !is_space(static_cast<unsigned char>(digits[length]))) break;
+
+    auto value = static_cast<literal>(digits_value(chunk,length));
+    p = digits + length;
+
+    if (value==null_literal) {
+      pos = p;
+      return true;
+    }
+    push_literal(c,value,negative);
+    maxvar = std::max(maxvar,value);
+  }
+  pos = p;
+  return false;
+}
+
+#endif
+
+
+#ifdef DIMACS_SIMD_SCAN
+
+// Bit i of the mask is set iff character p[i] is a space, for a block
+// of 16 (SSE2) or 32 (AVX2) characters. Characters 9...13 are the ones
+// which are less than -123 after adding 0x77, as signed bytes.
+struct sse2_blocks {
+  static const unsigned int width {16};
+
+  __attribute__((target("sse2")))
+  static uint64_t spaces(const char* p) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i blank   = _mm_cmpeq_epi8(x,_mm_set1_epi8(' '));
+    __m128i control = _mm_cmplt_epi8(_mm_add_epi8(x,_mm_set1_epi8(0x77)),_mm_set1_epi8(-123));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(blank,control)));
+  }
+};
+
+struct avx2_blocks {
+  static const unsigned int width {32};
+
+  __attribute__((target("avx2")))
+  static uint64_t spaces(const char* p) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i blank   = _mm256_cmpeq_epi8(x,_mm256_set1_epi8(' '));
+    __m256i control = _mm256_cmpgt_epi8(_mm256_set1_epi8(-123),
+                                        _mm256_add_epi8(x,_mm256_set1_epi8(0x77)));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(blank,control)));
+  }
+};
+
+// Block path: the mask of the spaces of a block gives the start and
+// the length of each token with two bit scans. A token which crosses
+// the end of the block is scanned again from the next block.
+template <typename Blocks,typename Clause>
+static bool scan_blocks(const char*& pos,const char* end,Clause& c,variable& maxvar) {
+
+  const uint64_t all = (uint64_t{1} << Blocks::width) - 1;
+  const char* base = pos;
+
+  // eight more characters are read after the digits of a token
+  while (end-base >= static_cast<std::ptrdiff_t>(Blocks::width+8)) {
+
+    uint64_t spaces = Blocks::spaces(base);
+    unsigned int offset {0};
+
+    while (true) {
+      uint64_t tokens = ~spaces & (all << offset) & all;
+      if (tokens==0) {
+        base += Blocks::width;
+        break;
+      }
+      unsigned int start = __builtin_ctzll(tokens);
+      uint64_t after = spaces & (all << start);
+      if (after==0) {
+        // a token as long as the block is left to the general code
+        if (start==0) {
+          pos = base;
+          return false;
+        }
+        base += start;
+        break;
+      }
+
+      const char* token = base + start;
+      unsigned int length = __builtin_ctzll(after) - start;
+      bool negative = (*token=='-');
+      unsigned int sign = (negative || *token=='+');
+      unsigned int digits = length - sign;
+
+      uint64_t chunk;
+      std::memcpy(&chunk,token+sign,sizeof(chunk));
+      if (digits==0 || digits>=8 || digits_length(chunk)!=digits) {
+        pos = token;
+        return false;
+      }
+
+      auto value = static_cast<literal>(digits_value(chunk,digits));
+      offset = start + length;
+
+      if (value==null_literal) {
+        pos = base + offset;
+        return true;
+      }
+      push_literal(c,value,negative);
+      maxvar = std::max(maxvar,value);
+    }
+  }
+  pos = base;
+  return false;
+}
+
+#endif
+
+
+template <typename Clause>
+variable dimacs_reader::read_clause_into(Clause& c) {
+
+  variable maxvar {0};
+
+  c.resize(0);
+
+  while (true) {
+
+#ifdef DIMACS_SWAR_SCAN
+    bool done;
+    switch (scanner) {
+#ifdef DIMACS_SIMD_SCAN
+      case dimacs_scanner::avx2:
+        done = scan_blocks<avx2_blocks>(pos,end,c,maxvar);
+        break;
+      case dimacs_scanner::sse2:
+        done = scan_blocks<sse2_blocks>(pos,end,c,maxvar);
+        break;
+#endif
+      default:
+        done = scan_scalar(pos,end,c,maxvar);
+    }
+    if (done) return maxvar;
+#endif
+
+    if (skip_spaces()==EOF)
+      throw dimacs_truncated{"Unexpected end of clause."};
+
+    literal lit = read_literal();
+    if (lit==null_literal) break;
+
+    literal value = lit < 0 ? -lit : lit;
+    push_literal(c,value,lit<0);
+    maxvar = std::max(maxvar,value);
+  }
+
+  return maxvar;
+}
+
+variable dimacs_reader::read_clause(clause& c) {
+  return read_clause_into(c);
+}
+
+variable dimacs_reader::read_clause(packed_clause& c) {
+  return read_clause_into(c);
+}
+
+
+const char* dimacs_clause_boundary(const char* p,const char* end) {
+
+  // move to the end of the current token
+  while (p<end && !is_space(static_cast<unsigned char>(*p))) ++p;
+
+  while (p<end) {
+    while (p<end && is_space(static_cast<unsigned char>(*p))) ++p;
+
+    // a token is a zero if it is an optional sign and then zeros
+    if (p<end && (*p=='-' || *p=='+')) ++p;
+    const char* digits = p;
+    while (p<end && *p=='0') ++p;
+
+    bool zero = (p>digits) && (p==end || is_space(static_cast<unsigned char>(*p)));
+    while (p<end && !is_space(static_cast<unsigned char>(*p))) ++p;
+    if (zero) return p;
+  }
+  return end;
+}
+
+
+std::vector<const char*> dimacs_pieces(const char* body,const char* end,unsigned int threads) {
+  size_t bytes  = static_cast<size_t>(end-body);
+  size_t pieces = std::min<size_t>({std::max(threads,1u),max_threads,
+                                    std::max<size_t>(bytes/dimacs_min_clause,1)});
+
+  std::vector<const char*> bounds(pieces+1,end);
+  bounds[0] = body;
+  for(size_t i=1; i<pieces; ++i) {
+    const char* guess = body + bytes/pieces*i;
+    bounds[i] = std::max(bounds[i-1],dimacs_clause_boundary(guess,end));
+  }
+  return bounds;
+}
+
+
+// Convert a non empty sequence of digits into a number no larger than
+// `limit`.
+static bool digits_to_number(const string& data, uint64_t limit, uint64_t& value) {
+  if (data.empty()) return false;
+  value = 0;
+  for (const auto c : data) {
+    if (!is_digit(static_cast<unsigned char>(c))) return false;
+    auto digit = static_cast<unsigned int>(c-'0');
+    if (value > (limit-digit)/10) return false;
+    value = value*10 + digit;
+  }
+  return true;
+}
+
+
+void dimacs_reader::read_spec(variable& n, cnf::size_type& m) {
+
+  // looks for the cnf specification line, and ignore comments and
+  // empty lines preceding it.
+  while(true) {
+    int c = peek();
+
+    if (c==EOF)
+      throw dimacs_truncated{"Missing cnf specification line."};
+
+    if (c=='c') {
+      skip_line();
+      continue;
+    }
+
+    if (c=='p') break;
+
+    while (c!=EOF && c!='\n' && is_space(c)) {
+      ++pos;
+      c = peek();
+    }
+
+    if (c=='\n')
+      ++pos;
+    else if (c!=EOF)
+      throw dimacs_bad_syntax{"non comment line before cnf specification."};
+  }
+
+  // parse the specification line of the form 'p cnf n m'
+  string s_p   {read_word()};
+  string s_cnf {read_word()};
+  string s_n   {read_word()};
+  string s_m   {read_word()};
+
+  uint64_t value_n {0};
+  uint64_t value_m {0};
+
+  if (s_p!="p" || s_cnf!="cnf" ||
+      !digits_to_number(s_n,INT_MAX,value_n) ||
+      !digits_to_number(s_m,SIZE_MAX,value_m)) {
+    throw dimacs_bad_syntax{"Bad specification line: \"p  cnf  <nvars> <nclauses>\" expected."};
+  }
+
+  if (!read_word().empty())
+    throw dimacs_bad_syntax{"Running characters in the specification line."};
+
+  n = static_cast<variable>(value_n);
+  m = static_cast<cnf::size_type>(value_m);
+}
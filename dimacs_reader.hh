@@ -0,0 +1,159 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 10:12 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 10:12 (CEST) Massimo Lauria"
+
+  Description::
+
+  Low level tokenizer for dimacs files.
+
+  A `dimacs_reader` scans a dimacs file directly on a raw byte buffer,
+  without going through the formatted input of iostreams. The buffer
+  is either
+
+  1. a region of memory which holds the whole file (e.g. a string or
+     a memory mapped file). In this case nothing is copied: the
+     reader scans the memory in place;
+
+     dimacs_reader r {data, data+length};
+
+  2. an input stream, which is read in large blocks into an internal
+     buffer.
+
+     dimacs_reader r {cin};
+
+  The reader first parses the specification line (skipping comments
+  and empty lines before it), and then it returns the clauses one by
+  one
+
+     variable n;
+     cnf::size_type m;
+     clause c;
+
+     r.read_spec(n,m);
+     for(size_t i=0;i<m;++i) r.read_clause(c);
+
+  The syntax accepted and the exceptions thrown are the ones described
+  in `dimacs_io.hh`. A reader on a piece of memory can also start in
+  the middle of a file, right after the end of a clause: then it reads
+  the clauses in that piece (see `dimacs_clause_boundary`). The reader
+  does not check the consistency of clauses with the specification
+  line: `read_clause` returns the largest variable index in the
+  clause, and the caller decides what to do with it.
+
+  When reading from a stream, the reader may consume more characters
+  than the ones it actually parses.
+
+  Clauses of short numbers are scanned by a fast path, which finds the
+  boundaries of the tokens with bitwise operations on blocks of bytes:
+  8 at a time with plain 64-bit arithmetic (`scalar`), or 16 or 32 at
+  a time with SSE2 or AVX2 instructions. The fastest path supported by
+  the processor is chosen at run time; `dimacs_set_scanner` selects
+  another one (e.g. for benchmarks) for the readers created
+  afterwards. All paths accept the same inputs and give the same
+  results: anything unusual is left to the general, byte by byte,
+  code.
+*/
+
+#ifndef _DIMACS_READER_HH_
+#define _DIMACS_READER_HH_
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cnf.hh"
+
+
+enum class dimacs_scanner { scalar, sse2, avx2 };
+
+// Whether the processor (and the compiler) support a scanner.
+bool dimacs_scanner_supported(dimacs_scanner s);
+
+// The scanner used by new readers: by default the fastest supported.
+dimacs_scanner dimacs_active_scanner();
+
+// Use scanner `s` in the readers created afterwards. It throws
+// std::invalid_argument if the scanner is not supported.
+void dimacs_set_scanner(dimacs_scanner s);
+
+
+class dimacs_reader {
+
+  private:
+
+    const char* pos;              // next character to be scanned
+    const char* end;              // end of the characters available
+    std::istream* in;             // source for more data, if any
+    std::vector<char> buffer;
+    dimacs_scanner scanner;
+
+    bool refill();
+
+    // next character, or EOF if the input is over
+    int peek() {
+      if (pos==end && !refill()) return EOF;
+      return static_cast<unsigned char>(*pos);
+    }
+
+    int skip_spaces();
+    void skip_line();
+    literal read_literal();
+    std::string read_word();
+
+    template <typename Clause>
+    variable read_clause_into(Clause& c);
+
+  public:
+
+    static const size_t default_buffer_size {1<<20};
+
+    dimacs_reader(const char* begin, const char* end);
+    dimacs_reader(std::istream& in, size_t buffer_size=default_buffer_size);
+
+    dimacs_reader(const dimacs_reader&) = delete;
+    dimacs_reader& operator=(const dimacs_reader&) = delete;
+
+    // Parse the specification line "p cnf <n> <m>", skipping the
+    // comments and the empty lines which precede it.
+    void read_spec(variable& n, cnf::size_type& m);
+
+    // Read the next clause into `c` and return the largest variable
+    // index mentioned by it.
+    variable read_clause(clause& c);
+    variable read_clause(packed_clause& c);
+
+    // Number of characters still to be scanned, if the input is in
+    // memory (zero for streams).
+    size_t memory_left() const { return in==nullptr ? end-pos : 0; }
+
+    // Position of the next character to be scanned, if the input is in
+    // memory.
+    const char* position() const { return pos; }
+
+    // True if the rest of the input is just spaces.
+    bool at_end() { return skip_spaces()==EOF; }
+};
+
+
+// Find the end of a clause in the body of a dimacs file in memory
+// (i.e. after the spec line). Starting from `p`, which may be in the
+// middle of a token, the function looks for the first token which
+// represents a zero and returns the position right after it, or `end`
+// if there is none. It is used to cut the body of a file into pieces
+// which can be parsed independently.
+const char* dimacs_clause_boundary(const char* p,const char* end);
+
+// Cut the body of a dimacs file in memory, from `body` to `end`, into
+// at most `threads` pieces which end at clause boundaries. There are
+// never more than `max_threads` pieces (see `parallel.hh`), nor more
+// than the clauses which fit in the body, i.e. a piece has at least
+// `dimacs_min_clause` bytes. The result has the bounds of the pieces:
+// it starts with `body` and ends with `end`.
+const size_t dimacs_min_clause {2};     // "0\n"
+std::vector<const char*> dimacs_pieces(const char* body,const char* end,unsigned int threads);
+
+
+#endif /* _DIMACS_READER_HH_ */
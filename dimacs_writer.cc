@@ -0,0 +1,141 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 15:30 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 15:30 (CEST) Massimo Lauria"
+
+  Description::
+
+  Buffered writer for dimacs files.
+
+  Implementation file: see the header file `dimacs_writer.hh` for
+  actual documentation.
+
+*/
+
+// Preamble
+#include <algorithm>
+#include <cstring>
+
+#include "dimacs_writer.hh"
+
+using std::ostream;
+
+
+// Code
+
+// enough room for a 64 bit number with its sign, plus " 0\n"
+static const size_t max_token {24};
+
+// "00" "01" ... "99": numbers are converted two digits at a time
+static const struct digit_pairs {
+  char value[200];
+  digit_pairs() {
+    for (int i=0; i<100; ++i) {
+      value[2*i]   = static_cast<char>('0'+i/10);
+      value[2*i+1] = static_cast<char>('0'+i%10);
+    }
+  }
+} pairs {};
+
+
+dimacs_writer::dimacs_writer(ostream& out, size_t buffer_size):
+  out{out},
+  buffer(std::max(buffer_size,2*max_token)),
+  pos{buffer.data()},
+  limit{buffer.data()+buffer.size()-max_token} {}
+
+dimacs_writer::~dimacs_writer() {
+  flush_buffer();
+}
+
+void dimacs_writer::flush_buffer() {
+  if (pos>buffer.data()) out.write(buffer.data(),pos-buffer.data());
+  pos = buffer.data();
+}
+
+void dimacs_writer::flush() {
+  flush_buffer();
+  out.flush();
+}
+
+
+// number of decimal digits of a value
+static inline size_t digits_number(unsigned long long value) {
+  size_t length {1};
+  while (value>=10000) {
+    value /= 10000;
+    length += 4;
+  }
+  return length + (value>=10) + (value>=100) + (value>=1000);
+}
+
+// write a number (there must be room for it). The digits are written
+// from the last one, two at a time.
+void dimacs_writer::put_number(unsigned long long value) {
+  size_t length = digits_number(value);
+  char*  p      = pos + length;
+
+  while (value>=100) {
+    p -= 2;
+    std::memcpy(p,pairs.value+2*(value%100),2);
+    value /= 100;
+  }
+  if (value>=10) {
+    p -= 2;
+    std::memcpy(p,pairs.value+2*value,2);
+  } else {
+    *(--p) = static_cast<char>('0'+value);
+  }
+
+  pos += length;
+}
+
+
+void dimacs_writer::write_spec(variable n, size_t m) {
+  make_room();
+  std::memcpy(pos,"p cnf ",6);
+  pos += 6;
+  put_number(static_cast<unsigned long long>(n));
+  *pos++ = ' ';
+  make_room();
+  put_number(m);
+  *pos++ = '\n';
+}
+
+
+// a literal, preceded by a space unless it is the first of the clause
+inline void dimacs_writer::put_literal(bool negative, unsigned long long value, bool first) {
+  make_room();
+  *pos = ' ';
+  pos += !first;
+  *pos = '-';
+  pos += negative;
+  put_number(value);
+}
+
+void dimacs_writer::write_clause(clause_view c) {
+  for (size_t i=0; i<c.size(); ++i) {
+    literal lit = c[i];
+    put_literal(lit<0,
+                static_cast<unsigned long long>(lit<0 ? -static_cast<long long>(lit) : lit),
+                i==0);
+  }
+  make_room();
+  std::memcpy(pos," 0\n",3);
+  pos += 3;
+}
+
+void dimacs_writer::write_clause(const packed_clause& c) {
+  for (size_t i=0; i<c.size(); ++i)
+    put_literal(c[i].negative(),static_cast<unsigned long long>(c[i].var()),i==0);
+  make_room();
+  std::memcpy(pos," 0\n",3);
+  pos += 3;
+}
+
+
+void dimacs_writer::write(const cnf& F) {
+  write_spec(F.variables_number(),F.size());
+  for (auto c : F) write_clause(c);
+}
@@ -0,0 +1,78 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 15:30 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 15:30 (CEST) Massimo Lauria"
+
+  Description::
+
+  Fast output of formulas in dimacs format.
+
+  A `dimacs_writer` formats the spec line and the clauses of a formula
+  into a large internal buffer, which is passed to the output stream
+  only when it is full, or when `flush` is called, or when the writer
+  is destroyed. Numbers are converted to text by hand, without the
+  formatted output of iostreams.
+
+     dimacs_writer w {cout};
+     w.write_spec(F.variables_number(),F.size());
+     for (auto c : F) w.write_clause(c);
+
+  or just
+
+     dimacs_writer w {cout};
+     w.write(F);
+
+  The output is exactly the one of `cout<<F` (which indeed uses
+  a `dimacs_writer`): one clause per line, with literals separated by
+  a single space and terminated by " 0".
+
+  Data written to the stream by other means while a writer on it is
+  alive may end up in the wrong place: flush the writer first.
+*/
+
+#ifndef _DIMACS_WRITER_HH_
+#define _DIMACS_WRITER_HH_
+
+#include <iostream>
+#include <vector>
+
+#include "cnf.hh"
+
+
+class dimacs_writer {
+
+  private:
+
+    std::ostream& out;
+    std::vector<char> buffer;
+    char* pos;                   // first free position in the buffer
+    char* limit;                 // flush before writing past this point
+
+    void put_number(unsigned long long value);
+    void put_literal(bool negative, unsigned long long value, bool first);
+
+    void make_room() { if (pos>=limit) flush_buffer(); }
+    void flush_buffer();
+
+  public:
+
+    static const size_t default_buffer_size {1<<20};
+
+    explicit dimacs_writer(std::ostream& out, size_t buffer_size=default_buffer_size);
+    ~dimacs_writer();
+
+    dimacs_writer(const dimacs_writer&) = delete;
+    dimacs_writer& operator=(const dimacs_writer&) = delete;
+
+    void write_spec(variable n, size_t m);
+    void write_clause(clause_view c);
+    void write_clause(const packed_clause& c);
+    void write(const cnf& F);
+
+    // send the buffer to the stream, and flush the stream
+    void flush();
+};
+
+
+#endif /* _DIMACS_WRITER_HH_ */
@@ -0,0 +1,331 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 22:30 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 22:30 (CEST) Massimo Lauria"
+
+  Description::
+
+  Bounded variable elimination.
+
+  Implementation file: see the header file `elimination.hh` for actual
+  documentation.
+
+*/
+
+// Preamble
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "elimination.hh"
+#include "occurrences.hh"
+
+using std::vector;
+
+
+// Code
+
+void elimination_stack::push(literal pivot,clause_view c) {
+  literals.push_back(pivot);
+  for (literal lit : c)
+    if (lit!=pivot) literals.push_back(lit);
+  offsets.push_back(literals.size());
+}
+
+
+void elimination_stack::extend(vector<bool>& model) const {
+  for (size_t i=size(); i-->0; ) {
+    const literal* first = literals.data()+offsets[i];
+    const literal* last  = literals.data()+offsets[i+1];
+    variable n {0};
+    for (const literal* p=first; p<last; ++p) n = std::max(n,abs(*p));
+    if (model.size()<=static_cast<size_t>(n)) model.resize(n+1,false);
+
+    bool satisfied {false};
+    for (const literal* p=first+1; p<last && !satisfied; ++p)
+      satisfied = (model[abs(*p)] == (*p>0));
+    if (!satisfied) model[abs(*first)] = (*first>0);
+  }
+}
+
+
+// Resolvent of clauses c and d on variable v, where c contains v and d
+// contains ¬v. Both are sorted by variable. Return false if the
+// resolvent is a tautology.
+static bool resolve(clause_view c,clause_view d,variable v,clause& resolvent) {
+  resolvent.resize(0);
+  size_t i {0}, j {0};
+  while (i<c.size() || j<d.size()) {
+    literal lit;
+    if (j==d.size() || (i<c.size() && abs(c[i])<abs(d[j]))) {
+      lit = c[i++];
+    } else if (i==c.size() || abs(d[j])<abs(c[i])) {
+      lit = d[j++];
+    } else {
+      if (c[i]!=d[j] && abs(c[i])!=v) return false;
+      lit = c[i];
+      ++i;
+      ++j;
+    }
+    if (abs(lit)!=v) resolvent.push_back(lit);
+  }
+  return true;
+}
+
+
+// Clauses which can be deleted, the resolvents added after them, and
+// the queue of the variables to try.
+class elimination {
+
+  private:
+
+    struct clause_info {
+      size_t   start;
+      uint32_t size;
+      bool     deleted;
+    };
+
+    const eliminate_options& options;
+
+    vector<literal>     literals;
+    vector<clause_info> clauses;
+    occurrence_list     occurs;
+
+    // binary heap of variables by cost, with the position of each
+    // variable (or -1)
+    vector<variable>    heap;
+    vector<long>        position;
+    vector<bool>        eliminated;
+
+    // resolvents of the last attempt
+    vector<literal>     pending;
+    vector<size_t>      pending_offsets;
+    clause              resolvent;
+    bool                empty_resolvent;
+
+    clause_view view(clause_id i) const {
+      const literal* first = literals.data()+clauses[i].start;
+      return {first,first+clauses[i].size};
+    }
+
+    uint64_t cost(variable v) const {
+      return static_cast<uint64_t>(occurs[v].size())*occurs[-v].size();
+    }
+
+    bool before(variable a,variable b) const {
+      uint64_t ca {cost(a)}, cb {cost(b)};
+      return ca<cb || (ca==cb && a<b);
+    }
+
+    void place(size_t i,variable v) {
+      heap[i] = v;
+      position[v] = static_cast<long>(i);
+    }
+
+    void sift_up(size_t i);
+    void sift_down(size_t i);
+    variable pop();
+    void touch(variable v);
+
+    bool try_resolvents(variable v);
+    void remove(clause_id i);
+    void add(clause_view c);
+
+  public:
+
+    elimination(const cnf& F,const eliminate_options& options);
+
+    bool run(elimination_stack& stack,eliminate_stats& stats);
+
+    cnf result(variable n) const;
+};
+
+
+elimination::elimination(const cnf& F,const eliminate_options& options):
+  options(options),
+  literals{},
+  clauses(F.size()),
+  occurs{F},
+  heap{},
+  position(static_cast<size_t>(F.variables_number())+1,-1),
+  eliminated(static_cast<size_t>(F.variables_number())+1,false),
+  pending{},
+  pending_offsets{},
+  resolvent{},
+  empty_resolvent{false} {
+
+  literals.reserve(F.literals_number());
+  for (size_t i=0; i<F.size(); ++i) {
+    clauses[i].start   = literals.size();
+    clauses[i].size    = static_cast<uint32_t>(F[i].size());
+    clauses[i].deleted = false;
+    literals.insert(literals.end(),F[i].begin(),F[i].end());
+  }
+
+  for (variable v=1; v<=F.variables_number(); ++v) touch(v);
+}
+
+
+void elimination::sift_up(size_t i) {
+  variable v {heap[i]};
+  while (i>0 && before(v,heap[(i-1)/2])) {
+    place(i,heap[(i-1)/2]);
+    i = (i-1)/2;
+  }
+  place(i,v);
+}
+
+void elimination::sift_down(size_t i) {
+  variable v {heap[i]};
+  while (2*i+1<heap.size()) {
+    size_t child {2*i+1};
+    if (child+1<heap.size() && before(heap[child+1],heap[child])) ++child;
+    if (!before(heap[child],v)) break;
+    place(i,heap[child]);
+    i = child;
+  }
+  place(i,v);
+}
+
+variable elimination::pop() {
+  variable v {heap[0]};
+  position[v] = -1;
+  variable last {heap.back()};
+  heap.pop_back();
+  if (!heap.empty()) {
+    place(0,last);
+    sift_down(0);
+  }
+  return v;
+}
+
+// The cost of v has changed: move it in the queue, or queue it again.
+void elimination::touch(variable v) {
+  if (eliminated[v]) return;
+  if (position[v]<0) {
+    heap.push_back(v);
+    sift_up(heap.size()-1);
+  } else {
+    size_t i = static_cast<size_t>(position[v]);
+    sift_up(i);
+    sift_down(static_cast<size_t>(position[v]));
+  }
+}
+
+
+// Compute the resolvents on v in `pending`, and return false as soon
+// as one of the bounds is exceeded. An empty resolvent is kept, and
+// it is recorded in `empty_resolvent`.
+bool elimination::try_resolvents(variable v) {
+  auto pos = occurs[v];
+  auto neg = occurs[-v];
+  if (pos.size()>options.max_occurrences || neg.size()>options.max_occurrences)
+    return false;
+
+  size_t bound {pos.size()+neg.size()+options.grow};
+  pending.resize(0);
+  pending_offsets.assign(1,0);
+  for (clause_id c : pos)
+    for (clause_id d : neg) {
+      if (!resolve(view(c),view(d),v,resolvent)) continue;
+      if (resolvent.size()>options.max_resolvent_width ||
+          pending_offsets.size()>bound) return false;
+      empty_resolvent = empty_resolvent || resolvent.empty();
+      pending.insert(pending.end(),resolvent.begin(),resolvent.end());
+      pending_offsets.push_back(pending.size());
+    }
+  return true;
+}
+
+void elimination::remove(clause_id i) {
+  occurs.remove(i,view(i));
+  clauses[i].deleted = true;
+}
+
+void elimination::add(clause_view c) {
+  clause_info info {literals.size(),static_cast<uint32_t>(c.size()),false};
+  literals.insert(literals.end(),c.begin(),c.end());
+  clauses.push_back(info);
+  occurs.add(static_cast<clause_id>(clauses.size()-1),view(static_cast<clause_id>(clauses.size()-1)));
+}
+
+
+// Eliminate variables until the queue is empty. Return false, without
+// eliminating v, if the resolvents on some variable v include the
+// empty clause.
+bool elimination::run(elimination_stack& stack,eliminate_stats& stats) {
+
+  vector<variable> touched {};
+  vector<clause_id> removed {};
+
+  while (!heap.empty()) {
+    variable v {pop()};
+    if (occurs[v].empty() && occurs[-v].empty()) continue;
+    if (!try_resolvents(v)) continue;
+    if (empty_resolvent) return false;
+
+    // the clauses of the smaller polarity go to the stack, then the
+    // default value of v
+    literal stored {occurs[v].size()<=occurs[-v].size() ? v : -v};
+    for (clause_id c : occurs[stored]) stack.push(stored,view(c));
+    stack.push(-stored,{-stored});
+
+    removed.assign(occurs[v].begin(),occurs[v].end());
+    removed.insert(removed.end(),occurs[-v].begin(),occurs[-v].end());
+    touched.resize(0);
+    for (clause_id c : removed) {
+      for (literal lit : view(c)) touched.push_back(abs(lit));
+      remove(c);
+    }
+    for (size_t r=0; r+1<pending_offsets.size(); ++r) {
+      clause_view c {pending.data()+pending_offsets[r],pending.data()+pending_offsets[r+1]};
+      for (literal lit : c) touched.push_back(abs(lit));
+      add(c);
+    }
+
+    eliminated[v] = true;
+    ++stats.eliminated_variables;
+    stats.removed_clauses += removed.size();
+    stats.added_clauses   += pending_offsets.size()-1;
+
+    std::sort(touched.begin(),touched.end());
+    touched.erase(std::unique(touched.begin(),touched.end()),touched.end());
+    for (variable u : touched) touch(u);
+  }
+  return true;
+}
+
+
+cnf elimination::result(variable n) const {
+  cnf G {n};
+  for (size_t i=0; i<clauses.size(); ++i)
+    if (!clauses[i].deleted) G.add_clause(view(static_cast<clause_id>(i)));
+  return G;
+}
+
+
+cnf eliminate(const cnf& F,const eliminate_options& options,
+              elimination_stack& stack,eliminate_stats& stats) {
+  stats = {{0,0,0},0,0,0,false};
+  cnf G {simplify(F,stats.simplified)};
+
+  bool empty_clause {false};
+  for (auto c : G) empty_clause = empty_clause || c.empty();
+  if (!empty_clause) {
+    elimination state {G,options};
+    if (state.run(stack,stats)) return state.result(F.variables_number());
+  }
+
+  stats.conflict = true;
+  cnf R {F.variables_number()};
+  R.add_clause(clause_view{});
+  return R;
+}
+
+
+cnf eliminate(const cnf& F) {
+  elimination_stack stack;
+  eliminate_stats stats;
+  return eliminate(F,{},stack,stats);
+}
@@ -0,0 +1,118 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 22:30 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 22:30 (CEST) Massimo Lauria"
+
+  Description::
+
+  Bounded variable elimination.
+
+  A variable x is eliminated from F by replacing the clauses which
+  contain x or ¬x with all their non tautological resolvents on x.
+  The result is satisfiable if and only if F is. Formulas produced by
+  encodings have many variables (e.g. definitions of gates) whose
+  elimination makes the formula smaller.
+
+  `eliminate(F)` first simplifies F (see `simplify.hh`), and then
+  eliminates a variable only if
+
+     - each of x and ¬x occurs in at most `max_occurrences` clauses;
+     - no resolvent is wider than `max_resolvent_width`;
+     - there are at most `grow` more resolvents than the clauses they
+       replace, so that the formula never gets larger (for grow=0).
+
+  Variables are tried in order of increasing cost, which is the
+  product of the occurrences of x and ¬x. When a variable is
+  eliminated, the variables of the removed clauses and of the
+  resolvents are "touched": their costs are updated, and the ones
+  which have already been tried are tried again, since their
+  occurrences have changed.
+
+     elimination_stack stack;
+     eliminate_stats stats;
+     cnf G {eliminate(F,{},stack,stats)};
+
+  The result is on the same variables as F, and the eliminated
+  variables do not occur in it. The clauses which survive keep their
+  relative order, and the resolvents follow them.
+
+  If F contains the empty clause, or some resolvent is empty, then F
+  is unsatisfiable: the elimination stops, the result is the formula
+  with only the empty clause, and `stats.conflict` is true.
+
+  A model of G is extended to a model of F by
+
+     std::vector<bool> model;   // model[v] is the value of variable v
+     ...
+     stack.extend(model);
+
+  The stack keeps the removed clauses of one polarity of each
+  eliminated variable x, the smaller one. When the model is extended,
+  the variables are considered in the reverse order of elimination: x
+  gets the value which falsifies its stored literal, and it is
+  flipped if some stored clause is not satisfied by the other
+  literals.
+*/
+
+#ifndef _ELIMINATION_HH_
+#define _ELIMINATION_HH_
+
+#include <vector>
+
+#include "cnf.hh"
+#include "simplify.hh"
+
+
+struct eliminate_options {
+  size_t max_occurrences     {100};
+  size_t max_resolvent_width {20};
+  size_t grow                {0};
+};
+
+// What has been changed by `eliminate`, in addition to `simplify`.
+struct eliminate_stats {
+  simplify_stats simplified;
+  size_t eliminated_variables;
+  size_t removed_clauses;
+  size_t added_clauses;
+  bool   conflict;
+};
+
+
+// Clauses removed by variable elimination, needed to extend models.
+class elimination_stack {
+
+  private:
+
+    std::vector<literal> literals;   // each clause has its pivot first
+    std::vector<size_t>  offsets;
+
+  public:
+
+    elimination_stack(): literals{}, offsets{0} {}
+
+    // add a clause whose first literal is `pivot` to the stack
+    void push(literal pivot,clause_view c);
+
+    // complete a model of the formula after elimination to a model of
+    // the formula before it. `model[v]` is the value of variable v,
+    // and the vector is enlarged if needed.
+    void extend(std::vector<bool>& model) const;
+
+    // number of clauses in the stack
+    size_t size() const { return offsets.size()-1; }
+
+    // the i-th clause pushed, with its pivot first
+    clause_view operator[](size_t i) const {
+      return {literals.data()+offsets[i],literals.data()+offsets[i+1]};
+    }
+};
+
+
+cnf eliminate(const cnf& F);
+cnf eliminate(const cnf& F,const eliminate_options& options,
+              elimination_stack& stack,eliminate_stats& stats);
+
+
+#endif /* _ELIMINATION_HH_ */
@@ -0,0 +1,176 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 23:55 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 23:55 (CEST) Massimo Lauria"
+
+  Description::
+
+  Substitution of equivalent literals.
+
+  Implementation file: see the header file `equivalences.hh` for actual
+  documentation.
+
+*/
+
+// Preamble
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "equivalences.hh"
+
+using std::vector;
+
+
+// Code
+
+// Implications of the binary clauses, by packed literal.
+class implication_graph {
+
+  private:
+
+    vector<size_t>   offsets;
+    vector<uint32_t> targets;
+
+  public:
+
+    explicit implication_graph(const cnf& F);
+
+    size_t nodes() const { return offsets.size()-1; }
+
+    const uint32_t* begin(uint32_t u) const { return targets.data()+offsets[u]; }
+    const uint32_t* end(uint32_t u)   const { return targets.data()+offsets[u+1]; }
+};
+
+
+// Count the implications of each literal, then fill the array.
+implication_graph::implication_graph(const cnf& F):
+  offsets(2*static_cast<size_t>(F.variables_number())+1,0),
+  targets{} {
+
+  for (auto c : F) {
+    if (c.size()!=2) continue;
+    ++offsets[(~packed_literal{c[0]}).index()+1];
+    ++offsets[(~packed_literal{c[1]}).index()+1];
+  }
+  for (size_t u=1; u<offsets.size(); ++u) offsets[u] += offsets[u-1];
+
+  targets.resize(offsets.back());
+  vector<size_t> next(offsets.begin(),offsets.end()-1);
+  for (auto c : F) {
+    if (c.size()!=2) continue;
+    packed_literal a {c[0]}, b {c[1]};
+    targets[next[(~a).index()]++] = b.index();
+    targets[next[(~b).index()]++] = a.index();
+  }
+}
+
+
+// Tarjan's algorithm. Each node gets the smallest node of its
+// component, and the component of each node is numbered.
+static void strongly_connected_components(const implication_graph& G,
+                                          vector<uint32_t>& smallest,
+                                          vector<uint32_t>& component) {
+  const uint32_t unvisited {UINT32_MAX};
+
+  struct frame {
+    uint32_t        node;
+    const uint32_t* next;       // next edge to follow
+  };
+
+  size_t n {G.nodes()};
+  vector<uint32_t> order(n,unvisited);
+  vector<uint32_t> low(n,0);
+  vector<bool>     on_stack(n,false);
+  vector<uint32_t> stack {};
+  vector<frame>    calls {};
+  uint32_t visited {0}, components {0};
+
+  smallest.assign(n,0);
+  component.assign(n,0);
+
+  auto visit = [&](uint32_t u) {
+    order[u] = low[u] = visited++;
+    stack.push_back(u);
+    on_stack[u] = true;
+    calls.push_back({u,G.begin(u)});
+  };
+
+  for (uint32_t root=0; root<n; ++root) {
+    if (order[root]!=unvisited) continue;
+    visit(root);
+    while (!calls.empty()) {
+      uint32_t u {calls.back().node};
+      if (calls.back().next!=G.end(u)) {
+        uint32_t w {*calls.back().next++};
+        if (order[w]==unvisited) visit(w);
+        else if (on_stack[w]) low[u] = std::min(low[u],order[w]);
+        continue;
+      }
+
+      calls.pop_back();
+      if (!calls.empty()) {
+        uint32_t parent {calls.back().node};
+        low[parent] = std::min(low[parent],low[u]);
+      }
+      if (low[u]!=order[u]) continue;
+
+      // u is the root of a component, which is on top of the stack
+      auto first = std::find(stack.rbegin(),stack.rend(),u).base()-1;
+      uint32_t least {*std::min_element(first,stack.end())};
+      for (auto p=first; p!=stack.end(); ++p) {
+        smallest[*p]  = least;
+        component[*p] = components;
+        on_stack[*p]  = false;
+      }
+      stack.erase(first,stack.end());
+      ++components;
+    }
+  }
+}
+
+
+cnf substitute_equivalences(const cnf& F,vector<literal>& representative,
+                            equivalence_stats& stats) {
+  stats = {{0,0,0},0,false};
+  variable n {F.variables_number()};
+  representative.assign(static_cast<size_t>(n)+1,null_literal);
+
+  vector<uint32_t> smallest, component;
+  strongly_connected_components(implication_graph{F},smallest,component);
+
+  // x and ¬x are in the same component exactly when some of their
+  // equivalent literals are. The component of ¬x is the negation of
+  // the one of x, hence the representative of ¬x is the negation of
+  // the one of x.
+  for (variable v=1; v<=n; ++v) {
+    packed_literal x {v,true};
+    if (component[x.index()]==component[(~x).index()]) {
+      stats.conflict = true;
+      cnf R {n};
+      R.add_clause(clause_view{});
+      return R;
+    }
+    representative[v] = packed_literal::from_index(smallest[x.index()]).dimacs();
+    stats.substituted_variables += (representative[v]!=v);
+  }
+
+  cnf G {n};
+  G.reserve(F.size(),F.literals_number());
+  clause substituted {};
+  for (auto c : F) {
+    substituted.resize(0);
+    for (literal lit : c)
+      substituted.push_back(lit>0 ? representative[lit] : -representative[-lit]);
+    G.add_clause(substituted);
+  }
+  return simplify(G,stats.simplified);
+}
+
+
+cnf substitute_equivalences(const cnf& F) {
+  vector<literal> representative;
+  equivalence_stats stats;
+  return substitute_equivalences(F,representative,stats);
+}
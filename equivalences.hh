@@ -0,0 +1,67 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 23:55 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 23:55 (CEST) Massimo Lauria"
+
+  Description::
+
+  Substitution of equivalent literals.
+
+  Each binary clause (a b) gives the implications ¬a → b and ¬b → a.
+  Literals in the same strongly connected component of the graph of
+  these implications imply each other, hence they are equivalent. For
+  example (¬x y) and (x ¬y) say that x and y are equivalent, and an
+  encoding of a circuit has such clauses for each wire.
+
+  `substitute_equivalences(F)` replaces each literal with the
+  representative of its component, which is the literal with the
+  smallest variable, and then simplifies the result (see
+  `simplify.hh`): the clauses which have become tautologies, e.g. the
+  binary clauses of the equivalences, or repeated clauses, disappear.
+
+     std::vector<literal> representative;
+     equivalence_stats stats;
+     cnf G {substitute_equivalences(F,representative,stats)};
+
+  The result is on the same variables as F, and the variables which
+  are not representatives do not occur in it. `representative[v]` is
+  the literal which has replaced v (v itself for a representative),
+  for v from 1 to n, hence a model of G is extended to a model of F
+  by giving each variable v the value of `representative[v]`.
+
+  If some component contains both a literal and its negation then F
+  is unsatisfiable: the result is the formula with only the empty
+  clause, and `stats.conflict` is true.
+
+  Implementation note: the graph is stored with the same layout as
+  the occurrence lists (the targets of all literals in a single array,
+  by packed literal), and the components are found by Tarjan's
+  algorithm, with an explicit stack instead of recursion so that long
+  chains of implications do not overflow the call stack. The time is
+  linear in the size of F.
+*/
+
+#ifndef _EQUIVALENCES_HH_
+#define _EQUIVALENCES_HH_
+
+#include <vector>
+
+#include "cnf.hh"
+#include "simplify.hh"
+
+
+// What has been changed by `substitute_equivalences`.
+struct equivalence_stats {
+  simplify_stats simplified;    // after the substitution
+  size_t substituted_variables;
+  bool   conflict;
+};
+
+
+cnf substitute_equivalences(const cnf& F);
+cnf substitute_equivalences(const cnf& F,std::vector<literal>& representative,
+                            equivalence_stats& stats);
+
+
+#endif /* _EQUIVALENCES_HH_ */
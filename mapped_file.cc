@@ -0,0 +1,89 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 11:20 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 11:20 (CEST) Massimo Lauria"
+
+  Description::
+
+  Memory mapped files.
+
+  Implementation file: see the header file `mapped_file.hh` for
+  actual documentation.
+
+*/
+
+// Preamble
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_file.hh"
+
+using std::string;
+
+
+// Code
+
+static std::system_error file_error(const string& path) {
+  return std::system_error{errno, std::generic_category(), path};
+}
+
+mapped_file::mapped_file(const string& path):
+  data{nullptr},
+  length{0},
+  mapped{false},
+  buffer{} {
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd<0) throw file_error(path);
+
+  struct stat info;
+  if (fstat(fd,&info)<0) {
+    auto error = file_error(path);
+    close(fd);
+    throw error;
+  }
+
+  if (S_ISREG(info.st_mode) && info.st_size>0) {
+
+    length = static_cast<size_t>(info.st_size);
+    void* region = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (region==MAP_FAILED) {
+      auto error = file_error(path);
+      close(fd);
+      throw error;
+    }
+    madvise(region, length, MADV_SEQUENTIAL);
+    data   = static_cast<const char*>(region);
+    mapped = true;
+
+  } else if (!S_ISREG(info.st_mode)) {
+
+    // not mappable: read everything
+    buffer.resize(1<<20);
+    while (true) {
+      if (length==buffer.size()) buffer.resize(2*buffer.size());
+      ssize_t n = read(fd, buffer.data()+length, buffer.size()-length);
+      if (n==0) break;
+      if (n<0) {
+        if (errno==EINTR) continue;
+        auto error = file_error(path);
+        close(fd);
+        throw error;
+      }
+      length += static_cast<size_t>(n);
+    }
+    data = buffer.data();
+  }
+
+  close(fd);
+}
+
+mapped_file::~mapped_file() {
+  if (mapped) munmap(const_cast<char*>(data), length);
+}
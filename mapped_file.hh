@@ -0,0 +1,55 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 11:20 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 11:20 (CEST) Massimo Lauria"
+
+  Description::
+
+  Read only access to the content of a file as a contiguous region of
+  memory.
+
+  A regular file is mapped in memory (POSIX `mmap`), so its content
+  is not copied and it is loaded on demand by the operating system.
+  Other files (pipes, devices, process substitutions...) cannot be
+  mapped, and their whole content is read into a buffer instead.
+
+     mapped_file file {"formula.cnf"};
+     dimacs_reader reader {file.begin(), file.end()};
+
+  The memory is released when the object is destroyed. If the file
+  cannot be opened or read, the constructor throws a
+  `std::system_error`.
+*/
+
+#ifndef _MAPPED_FILE_HH_
+#define _MAPPED_FILE_HH_
+
+#include <string>
+#include <vector>
+
+
+class mapped_file {
+
+  private:
+
+    const char* data;
+    size_t length;
+    bool mapped;
+    std::vector<char> buffer;   // file content, if it is not mapped
+
+  public:
+
+    explicit mapped_file(const std::string& path);
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    const char* begin() const { return data; }
+    const char* end()   const { return data+length; }
+    size_t      size()  const { return length; }
+};
+
+
+#endif /* _MAPPED_FILE_HH_ */
@@ -0,0 +1,173 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 19:40 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 19:40 (CEST) Massimo Lauria"
+
+  Description::
+
+  Occurrence lists of a CNF formula.
+
+  Implementation file: see the header file `occurrences.hh` for actual
+  documentation.
+
+*/
+
+// Preamble
+#include <algorithm>
+#include <stdexcept>
+
+#include "occurrences.hh"
+
+using std::vector;
+
+
+// Code
+
+// room for new occurrences in a bucket, when the array is built
+static inline size_t with_slack(size_t size) {
+  return size + size/8 + 1;
+}
+
+static void check_clause_number(size_t m) {
+  if (m > UINT32_MAX)
+    throw std::length_error{"Too many clauses for an occurrence list."};
+}
+
+
+occurrence_list::occurrence_list(variable n):
+  ids{},
+  buckets{},
+  indexed{0},
+  total{0},
+  wasted{0} {
+  if (n<0)
+    throw std::invalid_argument{"Number of variable must be non negative."};
+  grow(n);
+}
+
+
+occurrence_list::occurrence_list(const cnf& F):
+  ids{},
+  buckets(2*static_cast<size_t>(F.variables_number()),bucket{0,0,0}),
+  indexed{F.size()},
+  total{F.literals_number()},
+  wasted{0} {
+
+  check_clause_number(F.size());
+
+  // count the occurrences, then place the buckets one after the other
+  for (auto c : F)
+    for (literal lit : c) ++buckets[packed_literal{lit}.index()].size;
+
+  size_t start {0};
+  for (auto& b : buckets) {
+    b.start    = start;
+    b.capacity = with_slack(b.size);
+    start     += b.capacity;
+    b.size     = 0;
+  }
+  ids.resize(start);
+
+  clause_id id {0};
+  for (auto c : F) {
+    for (literal lit : c) {
+      auto& b = buckets[packed_literal{lit}.index()];
+      ids[b.start + b.size++] = id;
+    }
+    ++id;
+  }
+}
+
+
+// New variables have empty buckets, which get space at the first
+// occurrence.
+void occurrence_list::grow(variable n) {
+  size_t needed = 2*static_cast<size_t>(n);
+  if (needed > buckets.size()) buckets.resize(needed,bucket{ids.size(),0,0});
+}
+
+
+// Move a full bucket to the end of the array, with twice the space.
+// The last bucket of the array just grows in place.
+void occurrence_list::relocate(size_t i) {
+  auto& b = buckets[i];
+  size_t capacity = 2*b.capacity + 4;
+  if (b.start + b.capacity == ids.size()) {
+    ids.resize(b.start + capacity);
+  } else {
+    size_t start = ids.size();
+    ids.resize(start + capacity);
+    std::copy(ids.begin()+b.start, ids.begin()+b.start+b.size, ids.begin()+start);
+    wasted += b.capacity;
+    b.start = start;
+  }
+  b.capacity = capacity;
+}
+
+
+// Build the array again, without the abandoned buckets.
+void occurrence_list::compact() {
+  size_t start {0};
+  for (const auto& b : buckets) start += with_slack(b.size);
+
+  vector<clause_id> compacted(start);
+  start = 0;
+  for (auto& b : buckets) {
+    std::copy(ids.begin()+b.start, ids.begin()+b.start+b.size, compacted.begin()+start);
+    b.start    = start;
+    b.capacity = with_slack(b.size);
+    start     += b.capacity;
+  }
+  ids    = std::move(compacted);
+  wasted = 0;
+}
+
+
+void occurrence_list::add(clause_id id,clause_view c) {
+
+  variable n {0};
+  for (literal lit : c) {
+    if (lit==null_literal)
+      throw std::domain_error{"zero value is not allowed for a literal"};
+    n = std::max(abs(lit),n);
+  }
+  grow(n);
+
+  for (literal lit : c) {
+    size_t i = packed_literal{lit}.index();
+    if (buckets[i].size == buckets[i].capacity) {
+      if (wasted > ids.size()/2) compact();
+      if (buckets[i].size == buckets[i].capacity) relocate(i);
+    }
+    auto& b = buckets[i];
+    ids[b.start + b.size++] = id;
+    ++total;
+  }
+}
+
+
+void occurrence_list::remove(clause_id id,clause_view c) {
+  for (literal lit : c) {
+    if (lit==null_literal) continue;
+    size_t i = packed_literal{lit}.index();
+    if (i>=buckets.size()) continue;
+    auto& b = buckets[i];
+    auto first = ids.begin()+b.start;
+    auto last  = first+b.size;
+    auto pos   = std::find(first,last,id);
+    if (pos==last) continue;
+    std::copy(pos+1,last,pos);
+    --b.size;
+    --total;
+  }
+}
+
+
+void occurrence_list::update(const cnf& F) {
+  check_clause_number(F.size());
+  grow(F.variables_number());
+  for (size_t i=indexed; i<F.size(); ++i)
+    add(static_cast<clause_id>(i),F[i]);
+  indexed = std::max(indexed,F.size());
+}
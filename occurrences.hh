@@ -0,0 +1,145 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 19:40 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 19:40 (CEST) Massimo Lauria"
+
+  Description::
+
+  Occurrence lists of a CNF formula.
+
+  An `occurrence_list` maps each literal to the sequence of the
+  indices of the clauses which contain it, in the order in which they
+  have been indexed. It is the base of any analysis which needs to
+  find the clauses of a literal (subsumption, variable elimination,
+  pure literals...) without scanning the whole formula.
+
+     occurrence_list occurs {F};
+     for (auto i : occurs[-3]) {
+       // F[i] contains the literal -3
+     }
+
+  Lists can also be looked up by `packed_literal` (see `cnf.hh`),
+  which is how they are indexed.
+
+  The index is built from a formula in time linear in its size. When
+  clauses are added to the formula, the index is updated with
+
+     F.add_clause({-3,4});
+     occurs.update(F);        // index the clauses not yet indexed
+
+  or by giving a single clause and its index with `add`. A clause
+  which mentions a new variable extends the index. Occurrences can be
+  removed with `remove`, e.g. when a clause is deleted from the
+  analysis.
+
+  Implementation note: all lists are stored in a single array
+  (compressed sparse rows). Each literal has a bucket in the array,
+  with some room for new occurrences. A bucket which is full is moved
+  to the end of the array with twice its capacity, so that additions
+  take amortized constant time; when the buckets left behind take too
+  much space the array is compacted. Clause indices are 32-bit, hence
+  a formula can have at most 2^32-1 clauses.
+*/
+
+#ifndef _OCCURRENCES_HH_
+#define _OCCURRENCES_HH_
+
+#include <cstdint>
+#include <vector>
+
+#include "cnf.hh"
+
+
+using clause_id = uint32_t;
+
+
+// Read only view of the occurrences of a literal.
+class occurrence_view {
+
+  private:
+
+    const clause_id* first;
+    const clause_id* last;
+
+  public:
+
+    using size_type      = size_t;
+    using value_type     = clause_id;
+    using const_iterator = const clause_id*;
+    using iterator       = const clause_id*;
+
+    occurrence_view(const clause_id* first, const clause_id* last): first{first}, last{last} {}
+
+    const_iterator begin() const { return first; }
+    const_iterator end()   const { return last; }
+
+    size_type size()  const { return last-first; }
+    bool      empty() const { return first==last; }
+
+    clause_id operator[](size_type i) const { return first[i]; }
+};
+
+
+class occurrence_list {
+
+  private:
+
+    struct bucket {
+      size_t start;
+      size_t size;
+      size_t capacity;
+    };
+
+    std::vector<clause_id> ids;      // all buckets, with gaps
+    std::vector<bucket>    buckets;  // by packed literal
+    size_t indexed;                  // clauses of the formula in the index
+    size_t total;                    // occurrences in the index
+    size_t wasted;                   // space of the abandoned buckets
+
+    void grow(variable n);
+    void relocate(size_t b);
+    void compact();
+
+  public:
+
+    occurrence_list(variable n=0);
+    explicit occurrence_list(const cnf& F);
+
+    variable variables_number() const { return static_cast<variable>(buckets.size()/2); }
+
+    // number of clauses indexed by `update` (and by the constructor)
+    size_t clauses_number() const { return indexed; }
+
+    // the clauses which contain `lit`. The view is invalidated by any
+    // change to the index.
+    occurrence_view operator[](packed_literal lit) const {
+      size_t b = lit.index();
+      if (b>=buckets.size()) return {nullptr,nullptr};
+      const clause_id* first = ids.data()+buckets[b].start;
+      return {first,first+buckets[b].size};
+    }
+
+    occurrence_view operator[](literal lit) const {
+      if (lit==null_literal) return {nullptr,nullptr};
+      return (*this)[packed_literal{lit}];
+    }
+
+    // index the clauses of F which have been added after the last
+    // update. F must be the indexed formula, with more clauses.
+    void update(const cnf& F);
+
+    // add the occurrences of the literals of `c`, as clause `id`.
+    void add(clause_id id,clause_view c);
+
+    // remove the occurrences of the literals of `c`, as clause `id`.
+    // The other occurrences keep their order. Literals which do not
+    // occur in clause `id` are ignored.
+    void remove(clause_id id,clause_view c);
+
+    // total number of occurrences
+    size_t size() const { return total; }
+};
+
+
+#endif /* _OCCURRENCES_HH_ */
@@ -0,0 +1,87 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 14:05 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 14:05 (CEST) Massimo Lauria"
+
+  Description::
+
+  Minimal support for running independent tasks on several threads.
+
+     parallel_for(n, threads, [&](size_t i) { ... });
+
+  runs the task for every i in [0,n), using at most `threads` threads
+  (the calling thread included), and never more than `max_threads`. Tasks are handed out one at a time,
+  so they do not need to have the same size. If some task throws, the
+  remaining ones are not started and the exception is rethrown by
+  `parallel_for` once all threads are done.
+
+  The number of threads requested by the user is usually passed
+  through `thread_count`, so that 0 means "all available cores". A
+  command line option is parsed by `thread_option`, which rejects
+  negative numbers and caps the count at `max_threads`.
+*/
+
+#ifndef _PARALLEL_HH_
+#define _PARALLEL_HH_
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+const unsigned int max_threads {256};
+
+inline unsigned int thread_count(unsigned int requested) {
+  if (requested>0) return std::min(requested,max_threads);
+  return std::max(1u,std::min(std::thread::hardware_concurrency(),max_threads));
+}
+
+// number of threads given as text, e.g. the value of option -j
+inline unsigned int thread_option(const std::string& text) {
+  int value {std::stoi(text)};
+  if (value<0) throw std::out_of_range{"Negative number of threads."};
+  return thread_count(static_cast<unsigned int>(value));
+}
+
+
+template <typename Task>
+void parallel_for(size_t n,unsigned int threads,Task task) {
+
+  if (threads<=1 || n<=1) {
+    for(size_t i=0;i<n;++i) task(i);
+    return;
+  }
+
+  std::atomic<size_t> next {0};
+  std::exception_ptr  error {nullptr};
+  std::mutex          error_lock;
+
+  auto worker = [&]() {
+    size_t i;
+    while ((i = next++) < n) {
+      try {
+        task(i);
+      } catch(...) {
+        std::lock_guard<std::mutex> guard {error_lock};
+        if (!error) error = std::current_exception();
+        next = n;
+      }
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for(size_t t=1; t<threads && t<n && t<max_threads; ++t) pool.emplace_back(worker);
+  worker();
+  for(auto& th : pool) th.join();
+
+  if (error) std::rethrow_exception(error);
+}
+
+
+#endif /* _PARALLEL_HH_ */
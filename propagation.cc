@@ -0,0 +1,235 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 23:40 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 23:40 (CEST) Massimo Lauria"
+
+  Description::
+
+  Unit propagation and pure literals.
+
+  Implementation file: see the header file `propagation.hh` for actual
+  documentation.
+
+*/
+
+// Preamble
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "propagation.hh"
+#include "occurrences.hh"
+
+using std::vector;
+
+
+// Code
+
+// Values of the literals, by packed index.
+static const signed char unassigned {0};
+static const signed char is_true    {1};
+static const signed char is_false   {-1};
+
+
+// Clauses with their two watched literals in front, the watch lists
+// and the trail of the assigned literals.
+class propagation {
+
+  private:
+
+    vector<packed_literal>    literals;
+    vector<size_t>            offsets;
+    vector<vector<clause_id>> watches;   // by packed literal
+    vector<signed char>       values;    // by packed literal
+    vector<packed_literal>    trail;
+    size_t                    head;      // first literal to propagate
+    bool                      conflict;
+
+  public:
+
+    explicit propagation(const cnf& F);
+
+    signed char value(packed_literal lit) const { return values[lit.index()]; }
+
+    // set `lit` to true. Return false if it is already false.
+    bool assign(packed_literal lit);
+
+    // propagate the trail until a fixpoint or a conflict. Return
+    // false on conflict.
+    bool run();
+
+    const vector<packed_literal>& assigned() const { return trail; }
+};
+
+
+propagation::propagation(const cnf& F):
+  literals{},
+  offsets{0},
+  watches(2*static_cast<size_t>(F.variables_number())),
+  values(2*static_cast<size_t>(F.variables_number()),unassigned),
+  trail{},
+  head{0},
+  conflict{false} {
+
+  literals.reserve(F.literals_number());
+  offsets.reserve(F.size()+1);
+  for (auto c : F) {
+    if (c.size()==0) {
+      conflict = true;
+    } else if (c.size()==1) {
+      conflict = conflict || !assign(packed_literal{c[0]});
+    } else {
+      auto id = static_cast<clause_id>(offsets.size()-1);
+      for (literal lit : c) literals.emplace_back(lit);
+      watches[literals[offsets.back()].index()].push_back(id);
+      watches[literals[offsets.back()+1].index()].push_back(id);
+      offsets.push_back(literals.size());
+    }
+  }
+}
+
+
+bool propagation::assign(packed_literal lit) {
+  if (value(lit)!=unassigned) return value(lit)==is_true;
+  values[lit.index()]    = is_true;
+  values[(~lit).index()] = is_false;
+  trail.push_back(lit);
+  return true;
+}
+
+
+// Each clause which watches a literal that became false has it in the
+// second position. Either it finds another literal which is not false,
+// and moves to its watch list, or it is satisfied, unit or falsified
+// and keeps watching the same literals.
+bool propagation::run() {
+  while (!conflict && head<trail.size()) {
+    packed_literal falsified {~trail[head++]};
+    vector<clause_id>& watching = watches[falsified.index()];
+
+    size_t i {0}, j {0};
+    while (i<watching.size()) {
+      clause_id c {watching[i++]};
+      packed_literal* first = literals.data()+offsets[c];
+      packed_literal* last  = literals.data()+offsets[c+1];
+      if (first[0]==falsified) std::swap(first[0],first[1]);
+
+      if (value(first[0])==is_true) {
+        watching[j++] = c;
+        continue;
+      }
+      packed_literal* p {first+2};
+      while (p<last && value(*p)==is_false) ++p;
+      if (p<last) {
+        std::swap(first[1],*p);
+        watches[first[1].index()].push_back(c);
+        continue;
+      }
+      watching[j++] = c;
+      if (!assign(first[0])) {
+        conflict = true;
+        while (i<watching.size()) watching[j++] = watching[i++];
+      }
+    }
+    watching.resize(j);
+  }
+  return !conflict;
+}
+
+
+// Set the pure literals of G to true and remove their clauses. A
+// literal becomes pure when the last clause with its negation is
+// removed.
+static cnf remove_pure_literals(const cnf& G,vector<signed char>& values,
+                                vector<literal>& assigned,propagate_stats& stats) {
+  occurrence_list occurs {G};
+  vector<size_t> count(values.size(),0);
+  for (size_t i=0; i<count.size(); ++i)
+    count[i] = occurs[packed_literal::from_index(static_cast<uint32_t>(i))].size();
+
+  vector<packed_literal> queue {};
+  for (size_t i=0; i<count.size(); ++i)
+    if (count[i]>0 && count[i^1]==0)
+      queue.push_back(packed_literal::from_index(static_cast<uint32_t>(i)));
+
+  vector<bool> removed(G.size(),false);
+  for (size_t q=0; q<queue.size(); ++q) {
+    packed_literal pure {queue[q]};
+    if (values[pure.index()]!=unassigned || count[pure.index()]==0) continue;
+    values[pure.index()]    = is_true;
+    values[(~pure).index()] = is_false;
+    assigned.push_back(pure.dimacs());
+    ++stats.pure_literals;
+
+    for (clause_id c : occurs[pure]) {
+      if (removed[c]) continue;
+      removed[c] = true;
+      ++stats.satisfied_clauses;
+      for (literal lit : G[c]) {
+        packed_literal p {lit};
+        if (--count[p.index()]==0 && count[(~p).index()]>0) queue.push_back(~p);
+      }
+    }
+  }
+
+  cnf R {G.variables_number()};
+  R.reserve(G.size(),G.literals_number());
+  for (size_t i=0; i<G.size(); ++i)
+    if (!removed[i]) R.add_clause(G[i]);
+  return R;
+}
+
+
+cnf propagate(const cnf& F,vector<literal>& assigned,propagate_stats& stats) {
+  stats = {{0,0,0},0,0,0,0,false};
+  assigned.resize(0);
+  cnf G {simplify(F,stats.simplified)};
+
+  propagation state {G};
+  if (!state.run()) {
+    for (packed_literal lit : state.assigned()) assigned.push_back(lit.dimacs());
+    stats.units    = assigned.size();
+    stats.conflict = true;
+    cnf R {F.variables_number()};
+    R.add_clause(clause_view{});
+    return R;
+  }
+
+  vector<signed char> values(2*static_cast<size_t>(F.variables_number()),unassigned);
+  for (packed_literal lit : state.assigned()) {
+    assigned.push_back(lit.dimacs());
+    values[lit.index()]    = is_true;
+    values[(~lit).index()] = is_false;
+  }
+  stats.units = assigned.size();
+
+  // remove the satisfied clauses and the false literals
+  cnf R {F.variables_number()};
+  R.reserve(G.size(),G.literals_number());
+  clause reduced {};
+  for (auto c : G) {
+    bool satisfied {false};
+    reduced.resize(0);
+    for (literal lit : c) {
+      signed char v {values[packed_literal{lit}.index()]};
+      if (v==is_true) { satisfied = true; break; }
+      if (v==unassigned) reduced.push_back(lit);
+    }
+    if (satisfied) {
+      ++stats.satisfied_clauses;
+      continue;
+    }
+    stats.false_literals += c.size()-reduced.size();
+    R.add_clause(reduced);
+  }
+
+  return remove_pure_literals(R,values,assigned,stats);
+}
+
+
+cnf propagate(const cnf& F) {
+  vector<literal> assigned;
+  propagate_stats stats;
+  return propagate(F,assigned,stats);
+}
@@ -0,0 +1,71 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 23:40 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 23:40 (CEST) Massimo Lauria"
+
+  Description::
+
+  Unit propagation and pure literals.
+
+  `propagate(F)` simplifies F (see `simplify.hh`), then
+
+     - sets the literal of each unit clause to true, and propagates
+       the assignment until no clause is unit, i.e. until every
+       clause is either satisfied or has two unassigned literals;
+     - removes the satisfied clauses, and the false literals from the
+       other clauses;
+     - sets to true each pure literal, i.e. a literal whose negation
+       does not occur in the remaining clauses, and removes its
+       clauses. This may make other literals pure.
+
+  The result is on the same variables as F, and the clauses keep
+  their relative order. The literals set to true are returned in the
+  order in which they have been assigned, first the ones forced by
+  unit propagation and then the pure ones: any model of the result,
+  together with this assignment, is a model of F.
+
+     std::vector<literal> assigned;
+     propagate_stats stats;
+     cnf G {propagate(F,assigned,stats)};
+     if (stats.conflict) ...     // F is unsatisfiable
+
+  If the propagation falsifies a clause then F is unsatisfiable: the
+  result is the formula with only the empty clause, and
+  `stats.conflict` is true. The propagation stops at the first
+  conflict.
+
+  Implementation note: the propagation watches two literals of each
+  clause, which are not false unless the clause is satisfied or unit.
+  When a literal becomes false only the clauses which watch it are
+  visited, and each of them either finds another literal to watch or
+  is unit (or falsified). The cost of an assignment then depends on
+  the clauses watching the literal, not on the size of the formula,
+  and nothing has to be undone at the end.
+*/
+
+#ifndef _PROPAGATION_HH_
+#define _PROPAGATION_HH_
+
+#include <vector>
+
+#include "cnf.hh"
+#include "simplify.hh"
+
+
+// What has been changed by `propagate`, in addition to `simplify`.
+struct propagate_stats {
+  simplify_stats simplified;
+  size_t units;                 // literals forced by propagation
+  size_t pure_literals;
+  size_t satisfied_clauses;     // removed
+  size_t false_literals;        // removed from the other clauses
+  bool   conflict;
+};
+
+
+cnf propagate(const cnf& F);
+cnf propagate(const cnf& F,std::vector<literal>& assigned,propagate_stats& stats);
+
+
+#endif /* _PROPAGATION_HH_ */
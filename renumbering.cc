@@ -0,0 +1,100 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 23:59 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 23:59 (CEST) Massimo Lauria"
+
+  Description::
+
+  Renumbering of the variables of a CNF formula.
+
+  Implementation file: see the header file `renumbering.hh` for actual
+  documentation.
+
+*/
+
+// Preamble
+#include <algorithm>
+
+#include "renumbering.hh"
+#include "occurrences.hh"
+
+using std::vector;
+
+
+// Code
+
+// The variables which occur in F, in order of search. The variables
+// reached from the same one are sorted by occurrences if `by_degree`,
+// and then the searches start from the variables with fewest
+// occurrences.
+static vector<variable> search_order(const cnf& F,bool by_degree) {
+  variable n {F.variables_number()};
+  occurrence_list occurs {F};
+  vector<size_t> degree(static_cast<size_t>(n)+1,0);
+  for (variable v=1; v<=n; ++v) degree[v] = occurs[v].size()+occurs[-v].size();
+  auto fewer = [&](variable a,variable b) { return degree[a]<degree[b]; };
+
+  vector<variable> starts {};
+  for (variable v=1; v<=n; ++v)
+    if (degree[v]>0) starts.push_back(v);
+  if (by_degree) std::stable_sort(starts.begin(),starts.end(),fewer);
+
+  vector<bool> reached(static_cast<size_t>(n)+1,false);
+  vector<bool> visited(F.size(),false);
+  vector<variable> order {};
+  order.reserve(starts.size());
+  for (variable s : starts) {
+    if (reached[s]) continue;
+    reached[s] = true;
+    order.push_back(s);
+    for (size_t head=order.size()-1; head<order.size(); ++head) {
+      variable v {order[head]};
+      size_t batch {order.size()};
+      for (literal lit : {v,-v})
+        for (clause_id c : occurs[lit]) {
+          if (visited[c]) continue;
+          visited[c] = true;
+          for (literal l : F[c]) {
+            if (reached[abs(l)]) continue;
+            reached[abs(l)] = true;
+            order.push_back(abs(l));
+          }
+        }
+      if (by_degree) std::stable_sort(order.begin()+batch,order.end(),fewer);
+    }
+  }
+  return order;
+}
+
+
+cnf renumber(const cnf& F,vector<variable>& original,variable_order order) {
+  variable n {F.variables_number()};
+
+  if (order==variable_order::compact) {
+    vector<bool> used(static_cast<size_t>(n)+1,false);
+    for (auto c : F)
+      for (literal lit : c) used[abs(lit)] = true;
+    original.resize(0);
+    for (variable v=1; v<=n; ++v)
+      if (used[v]) original.push_back(v);
+  } else {
+    original = search_order(F,order==variable_order::reverse_cuthill_mckee);
+    if (order==variable_order::reverse_cuthill_mckee)
+      std::reverse(original.begin(),original.end());
+  }
+
+  vector<variable> renamed(static_cast<size_t>(n)+1,0);
+  for (size_t j=0; j<original.size(); ++j)
+    renamed[original[j]] = static_cast<variable>(j+1);
+
+  cnf G {static_cast<variable>(original.size())};
+  G.reserve(F.size(),F.literals_number());
+  clause renumbered {};
+  for (auto c : F) {
+    renumbered.resize(0);
+    for (literal lit : c) renumbered.push_back(lit>0 ? renamed[lit] : -renamed[-lit]);
+    G.add_clause(renumbered);
+  }
+  return G;
+}
@@ -0,0 +1,63 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 23:59 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 23:59 (CEST) Massimo Lauria"
+
+  Description::
+
+  Renumbering of the variables of a CNF formula.
+
+  A formula may declare many more variables than it uses, or number
+  them in a random order. Then the arrays indexed by variable (in the
+  library and in solvers) waste memory, and related variables are far
+  apart in memory. `renumber(F)` gives the variables which occur in F
+  the numbers 1,2,...,k, and `variables_number()` of the result is k.
+
+     std::vector<variable> original;
+     cnf G {renumber(F,original,variable_order::reverse_cuthill_mckee)};
+     // variable j of G is original[j-1] in F
+
+  The order of the new numbers is
+
+     compact                 the order of the variables in F;
+     bfs                     breadth first search of the graph where two
+                             variables are adjacent if they occur in the
+                             same clause, starting from the smallest
+                             variable of each connected component;
+     reverse_cuthill_mckee   as bfs, but each search starts from a
+                             variable with fewest occurrences, the
+                             variables reached from the same variable
+                             are sorted by occurrences, and the whole
+                             order is reversed.
+
+  The last two give close numbers to variables in the same clauses,
+  i.e. they reduce the bandwidth of the graph. The clauses keep their
+  order, and the literals their positions in the clauses.
+
+  `original` has the same meaning as the variables of a component
+  (see `components.hh`), and it is saved with `write_variable_map`.
+  A model of G is translated back by giving to original[j-1] the value
+  of j; the variables which do not occur in F can have any value.
+
+  Implementation note: the search visits the clauses of each variable
+  through the occurrence lists, and each clause only once, so that it
+  takes linear time even if the graph has a clique for each clause.
+*/
+
+#ifndef _RENUMBERING_HH_
+#define _RENUMBERING_HH_
+
+#include <vector>
+
+#include "cnf.hh"
+
+
+enum class variable_order { compact, bfs, reverse_cuthill_mckee };
+
+
+cnf renumber(const cnf& F,std::vector<variable>& original,
+             variable_order order=variable_order::compact);
+
+
+#endif /* _RENUMBERING_HH_ */
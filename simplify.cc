@@ -0,0 +1,316 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 19:05 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 19:05 (CEST) Massimo Lauria"
+
+  Description::
+
+  Simplification of CNF formulas.
+
+  Implementation file: see the header file `simplify.hh` for actual
+  documentation.
+
+*/
+
+// Preamble
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "simplify.hh"
+#include "occurrences.hh"
+
+using std::vector;
+
+
+// Code
+
+// literals of the same variable are adjacent, negative first
+static inline bool by_variable(literal a,literal b) {
+  return abs(a)<abs(b) || (abs(a)==abs(b) && a<b);
+}
+
+static uint64_t clause_hash(const clause& c) {
+  uint64_t h {0x9E3779B97F4A7C15ULL ^ c.size()};
+  for (literal lit : c) {
+    h = (h ^ static_cast<uint32_t>(lit)) * 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 29;
+  }
+  return h;
+}
+
+
+// Sort the literals of `c` and remove the repeated ones. Return false
+// if the clause is a tautology.
+static bool normalize(clause& c) {
+  std::sort(c.begin(),c.end(),by_variable);
+  size_t size {0};
+  for (literal lit : c) {
+    if (size>0 && abs(c[size-1])==abs(lit)) {
+      if (c[size-1]!=lit) return false;
+      continue;
+    }
+    c[size++] = lit;
+  }
+  c.resize(size);
+  return true;
+}
+
+
+cnf simplify(const cnf& F,simplify_stats& stats) {
+
+  stats = {0,0,0};
+
+  cnf G {F.variables_number()};
+  G.reserve(F.size(),F.literals_number());
+
+  // Open addressing hash table of the clauses of G, at most half full.
+  const size_t empty {SIZE_MAX};
+  size_t capacity {16};
+  while (capacity < 2*F.size()) capacity *= 2;
+  vector<size_t>   table(capacity,empty);
+  vector<uint64_t> hashes {};
+  hashes.reserve(F.size());
+
+  clause c {};
+  for (auto cla : F) {
+
+    c.assign(cla.begin(),cla.end());
+    if (!normalize(c)) {
+      ++stats.tautologies;
+      continue;
+    }
+    stats.duplicate_literals += cla.size()-c.size();
+
+    uint64_t h    {clause_hash(c)};
+    size_t   slot {static_cast<size_t>(h) & (capacity-1)};
+    bool     seen {false};
+    while (table[slot]!=empty) {
+      size_t i {table[slot]};
+      if (hashes[i]==h && G[i]==clause_view{c}) {
+        seen = true;
+        break;
+      }
+      slot = (slot+1) & (capacity-1);
+    }
+    if (seen) {
+      ++stats.duplicate_clauses;
+      continue;
+    }
+
+    table[slot] = G.size();
+    hashes.push_back(h);
+    G.add_clause(c);
+  }
+  return G;
+}
+
+
+cnf simplify(const cnf& F) {
+  simplify_stats stats;
+  return simplify(F,stats);
+}
+
+
+// Subsumption
+
+// A bit for each variable in the 64-bit clause signatures.
+static inline uint64_t variable_bit(literal lit) {
+  uint64_t v = static_cast<uint64_t>(abs(lit));
+  return uint64_t{1} << ((v * 0x9E3779B97F4A7C15ULL) >> 58);
+}
+
+// Compare clauses C and D, both sorted by variable. Return true if
+// either C subsumes D, and then `flip` is null_literal, or C
+// strengthens D, and then `flip` is the literal to remove from D.
+static bool subsumes(const literal* c,size_t csize,
+                     const literal* d,size_t dsize,literal& flip) {
+  flip = null_literal;
+  size_t j {0};
+  for (size_t i=0; i<csize; ++i) {
+    while (j<dsize && abs(d[j])<abs(c[i])) ++j;
+    if (j==dsize || abs(d[j])!=abs(c[i])) return false;
+    if (d[j]!=c[i]) {
+      if (flip!=null_literal) return false;
+      flip = d[j];
+    }
+    ++j;
+  }
+  return true;
+}
+
+
+// Clauses which can be deleted and shrunk in place. The data used to
+// filter the candidates of a comparison is kept together, since it is
+// read for many clauses in random order.
+class subsumption {
+
+  private:
+
+    struct clause_info {
+      uint64_t signature;
+      size_t   start;
+      uint32_t size;
+      bool     deleted;
+      bool     queued;
+    };
+
+    vector<literal>     literals;
+    vector<clause_info> clauses;
+    vector<clause_id>   queue;
+    occurrence_list     occurs;
+
+    clause_view view(clause_id i) const {
+      const literal* first = literals.data()+clauses[i].start;
+      return {first,first+clauses[i].size};
+    }
+
+    void compute_signature(clause_id i) {
+      uint64_t signature {0};
+      for (literal lit : view(i)) signature |= variable_bit(lit);
+      clauses[i].signature = signature;
+    }
+
+    void strengthen(clause_id i,literal lit) {
+      occurs.remove(i,{lit});
+      auto first = literals.begin()+clauses[i].start;
+      auto last  = first+clauses[i].size;
+      auto pos   = std::find(first,last,lit);
+      std::copy(pos+1,last,pos);
+      --clauses[i].size;
+      compute_signature(i);
+      if (!clauses[i].queued) {
+        clauses[i].queued = true;
+        queue.push_back(i);
+      }
+    }
+
+    void remove(clause_id i) {
+      occurs.remove(i,view(i));
+      clauses[i].deleted = true;
+    }
+
+    void backward(clause_id c,subsume_stats& stats);
+
+  public:
+
+    explicit subsumption(const cnf& F);
+
+    void run(subsume_stats& stats);
+
+    cnf result(variable n,subsume_stats& stats) const;
+};
+
+
+subsumption::subsumption(const cnf& F):
+  literals{},
+  clauses(F.size()),
+  queue(F.size()),
+  occurs{F} {
+
+  literals.reserve(F.literals_number());
+  for (size_t i=0; i<F.size(); ++i) {
+    clauses[i].start   = literals.size();
+    clauses[i].size    = static_cast<uint32_t>(F[i].size());
+    clauses[i].deleted = false;
+    clauses[i].queued  = true;
+    literals.insert(literals.end(),F[i].begin(),F[i].end());
+    compute_signature(static_cast<clause_id>(i));
+  }
+
+  // short clauses first, since they subsume more
+  for (size_t i=0; i<F.size(); ++i) queue[i] = static_cast<clause_id>(i);
+  std::stable_sort(queue.begin(),queue.end(),
+                   [this](clause_id a,clause_id b) { return clauses[a].size<clauses[b].size; });
+}
+
+
+// Remove or strengthen the clauses which are subsumed or strengthened
+// by clause c.
+void subsumption::backward(clause_id c,subsume_stats& stats) {
+
+  const clause_info& info = clauses[c];
+  if (info.size==0) return;
+
+  // the variable of c with fewest occurrences
+  literal pivot {null_literal};
+  size_t  fewest {SIZE_MAX};
+  for (literal lit : view(c)) {
+    packed_literal p {lit};
+    size_t count = occurs[p].size() + occurs[~p].size();
+    if (count<fewest) {
+      fewest = count;
+      pivot  = lit;
+    }
+  }
+
+  vector<clause_id> candidates {};
+  for (literal lit : {pivot,-pivot}) {
+    auto list = occurs[lit];
+    candidates.assign(list.begin(),list.end());
+    for (clause_id d : candidates) {
+      const clause_info& other = clauses[d];
+      if (d==c || other.deleted || other.size<info.size ||
+          (info.signature & ~other.signature)!=0) continue;
+
+      literal flip;
+      if (!subsumes(literals.data()+info.start,info.size,
+                    literals.data()+other.start,other.size,flip)) continue;
+
+      if (flip==null_literal) {
+        remove(d);
+        ++stats.subsumed_clauses;
+      } else {
+        strengthen(d,flip);
+        ++stats.strengthened_literals;
+      }
+    }
+  }
+}
+
+
+void subsumption::run(subsume_stats& stats) {
+  // clauses are queued again when they are strengthened
+  for (size_t head=0; head<queue.size(); ++head) {
+    clause_id c {queue[head]};
+    clauses[c].queued = false;
+    if (!clauses[c].deleted) backward(c,stats);
+  }
+}
+
+
+cnf subsumption::result(variable n,subsume_stats& stats) const {
+
+  // The empty clause subsumes every other clause. Empty clauses are
+  // never deleted, but there may be several of them, if some clauses
+  // have been strengthened to the empty clause.
+  size_t empty {0};
+  while (empty<clauses.size() && clauses[empty].size>0) ++empty;
+
+  cnf G {n};
+  for (size_t i=0; i<clauses.size(); ++i) {
+    if (clauses[i].deleted) continue;
+    if (empty<clauses.size() && i!=empty) {
+      ++stats.subsumed_clauses;
+      continue;
+    }
+    G.add_clause(view(static_cast<clause_id>(i)));
+  }
+  return G;
+}
+
+
+cnf subsume(const cnf& F,subsume_stats& stats) {
+  stats = {{0,0,0},0,0};
+  cnf G {simplify(F,stats.simplified)};
+  subsumption state {G};
+  state.run(stats);
+  return state.result(F.variables_number(),stats);
+}
+
+
+cnf subsume(const cnf& F) {
+  subsume_stats stats;
+  return subsume(F,stats);
+}
@@ -0,0 +1,84 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 19:05 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 19:05 (CEST) Massimo Lauria"
+
+  Description::
+
+  Simplification of CNF formulas.
+
+  `cnf::add_clause` accepts any clause without zero literals, so a
+  formula may contain clauses with repeated literals, tautological
+  clauses (with both x and ¬x) and clauses which occur more than once.
+  Generated encodings have plenty of them, and cnf2kcnf would spend
+  extension variables to split them.
+
+  `simplify(F)` returns a formula equivalent to F, on the same
+  variables, where
+
+     - the literals of each clause are sorted by variable (negative
+       literal first) and the repeated ones are removed;
+     - tautological clauses are removed;
+     - only the first occurrence of each clause is kept (two clauses
+       are the same if they have the same literals, in any order).
+
+  The remaining clauses keep their relative order. Duplicate clauses
+  are found with a hash table of the simplified clauses, so the time
+  is linear in the size of the formula, plus the sorting of each
+  clause.
+
+     simplify_stats stats;
+     cnf G {simplify(F,stats)};
+     // stats.tautologies clauses of F are not in G, etc...
+
+  `subsume(F)` simplifies F as above, and then
+
+     - removes each clause D which is subsumed by another clause C,
+       i.e. C ⊆ D;
+     - strengthens each clause D for which there is a clause C and a
+       literal l such that l ∈ C, ¬l ∈ D and C \ {l} ⊆ D \ {¬l}: the
+       resolvent of C and D subsumes D, hence ¬l is removed from D
+       (self-subsuming resolution).
+
+  until no more clauses can be removed or strengthened. The result is
+  equivalent to F, on the same variables. The surviving clauses keep
+  their relative order.
+
+  Each clause C is compared only with the clauses in the occurrence
+  lists (see `occurrences.hh`) of one of its variables, the one with
+  fewest occurrences. Most of the comparisons are then decided by a
+  64-bit signature of the variables of each clause: C can subsume or
+  strengthen D only if the signature of C is contained in the one of
+  D. Only the remaining pairs are compared literal by literal.
+*/
+
+#ifndef _SIMPLIFY_HH_
+#define _SIMPLIFY_HH_
+
+#include "cnf.hh"
+
+
+// What has been removed by `simplify`.
+struct simplify_stats {
+  size_t duplicate_literals;    // in clauses which are not tautologies
+  size_t tautologies;
+  size_t duplicate_clauses;
+};
+
+cnf simplify(const cnf& F);
+cnf simplify(const cnf& F,simplify_stats& stats);
+
+
+// What has been removed by `subsume`, in addition to `simplify`.
+struct subsume_stats {
+  simplify_stats simplified;
+  size_t subsumed_clauses;
+  size_t strengthened_literals;
+};
+
+cnf subsume(const cnf& F);
+cnf subsume(const cnf& F,subsume_stats& stats);
+
+
+#endif /* _SIMPLIFY_HH_ */
@@ -0,0 +1,189 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 21:10 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 21:10 (CEST) Massimo Lauria"
+
+  Description::
+
+  Statistics of CNF formulas.
+
+  Implementation file: see the header file `statistics.hh` for actual
+  documentation.
+
+*/
+
+// Preamble
+#include <iterator>
+
+#include "statistics.hh"
+#include "cnf_cache.hh"
+#include "compression.hh"
+#include "dimacs_io.hh"
+#include "dimacs_reader.hh"
+#include "mapped_file.hh"
+#include "parallel.hh"
+
+using std::string;
+using std::vector;
+
+
+// Code
+
+cnf_statistics::cnf_statistics(variable n):
+  variables{n},
+  clauses{0},
+  literals{0},
+  widths{},
+  occurrences(2*static_cast<size_t>(n),0) {
+  if (n<0)
+    throw std::invalid_argument{"Number of variable must be non negative."};
+}
+
+
+// Literals of variables larger than `variables` are not allowed.
+void cnf_statistics::add_clause(clause_view c) {
+  if (c.size()>=widths.size()) widths.resize(c.size()+1,0);
+  ++widths[c.size()];
+  ++clauses;
+  literals += c.size();
+  for (literal lit : c) ++occurrences[packed_literal{lit}.index()];
+}
+
+void cnf_statistics::add_clause(const packed_clause& c) {
+  if (c.size()>=widths.size()) widths.resize(c.size()+1,0);
+  ++widths[c.size()];
+  ++clauses;
+  literals += c.size();
+  for (packed_literal lit : c) ++occurrences[lit.index()];
+}
+
+
+void cnf_statistics::merge(const cnf_statistics& other) {
+  if (other.widths.size()>widths.size()) widths.resize(other.widths.size(),0);
+  for (size_t w=0; w<other.widths.size(); ++w) widths[w] += other.widths[w];
+  for (size_t i=0; i<occurrences.size(); ++i) occurrences[i] += other.occurrences[i];
+  clauses  += other.clauses;
+  literals += other.literals;
+}
+
+
+cnf_statistics formula_statistics(const cnf& F) {
+  cnf_statistics s {F.variables_number()};
+  for (auto c : F) s.add_clause(c);
+  return s;
+}
+
+
+// Count the `m` clauses of a formula on `n` variables.
+static cnf_statistics count_clauses(dimacs_reader& reader,variable n,cnf::size_type m) {
+  cnf_statistics s {n};
+  packed_clause c;
+  for (size_t i=0; i<m; ++i) {
+    if (reader.read_clause(c) > n)
+      throw dimacs_bad_value{"Dimacs file contains clauses with invalid literals."};
+    s.add_clause(c);
+  }
+  return s;
+}
+
+cnf_statistics dimacs_statistics(dimacs_reader& reader) {
+  variable n {0};
+  cnf::size_type m {0};
+  reader.read_spec(n,m);
+  return count_clauses(reader,n,m);
+}
+
+
+// The body of the file is cut in pieces as in `parse_dimacs`, and the
+// counts of the pieces are added in order, up to the m-th clause. Only
+// a piece which holds the m-th clause and more, or which ends before
+// it with an error or at the end of the file, is scanned again, up to
+// the m-th clause: so trailers after the last clause (e.g. the `%` of
+// SATLIB files) cost nothing, and errors before it throw the same
+// exception as the sequential reader.
+cnf_statistics dimacs_statistics(const char* begin,const char* end,unsigned int threads) {
+
+  variable n {0};
+  cnf::size_type m {0};
+
+  dimacs_reader reader {begin,end};
+  reader.read_spec(n,m);
+
+  const char* body = reader.position();
+  vector<const char*> bounds {dimacs_pieces(body,end,threads)};
+  threads = static_cast<unsigned int>(bounds.size()-1);
+  if (threads<=1) return count_clauses(reader,n,m);
+
+  // each piece counts its clauses up to its end or its first error
+  vector<cnf_statistics> pieces(threads);
+  vector<char> failed(threads,0);
+  parallel_for(threads,threads,[&](size_t i) {
+      dimacs_reader chunk {bounds[i],bounds[i+1]};
+      cnf_statistics& s = pieces[i];
+      packed_clause c;
+      s = cnf_statistics{n};
+      try {
+        while (!chunk.at_end()) {
+          if (chunk.read_clause(c) > n) {
+            failed[i] = 1;
+            return;
+          }
+          s.add_clause(c);
+        }
+      } catch(...) {
+        failed[i] = 1;
+      }
+    });
+
+  cnf_statistics s {n};
+  for (unsigned int i=0; i<threads; ++i) {
+    size_t needed {m-s.clauses};
+    bool last {i+1==threads};
+    if (pieces[i].clauses==needed ||
+        (pieces[i].clauses<needed && !failed[i] && !last)) {
+      s.merge(pieces[i]);
+      pieces[i] = cnf_statistics{};
+      if (s.clauses==m) break;
+      continue;
+    }
+    pieces.clear();
+    dimacs_reader rest {bounds[i],end};
+    s.merge(count_clauses(rest,n,needed));
+    break;
+  }
+  return s;
+}
+
+
+// binary cache or dimacs file, from a stream of uncompressed data
+static cnf_statistics read_uncompressed(std::istream& in) {
+  if (in.peek()==static_cast<unsigned char>(cnf_cache_magic[0])) {
+    string data {std::istreambuf_iterator<char>{in},std::istreambuf_iterator<char>{}};
+    return formula_statistics(read_cnf_cache(data.data(),data.data()+data.size()));
+  }
+  dimacs_reader reader {in};
+  return dimacs_statistics(reader);
+}
+
+cnf_statistics read_statistics(std::istream& in) {
+  auto format = compression_by_magic(in);
+  if (format!=compression::none) {
+    decompressing_istream data {in,format};
+    return read_uncompressed(data);
+  }
+  return read_uncompressed(in);
+}
+
+cnf_statistics load_statistics_file(const string& path,unsigned int threads) {
+  mapped_file file {path};
+
+  auto format = compression_by_magic(file.begin(),file.end());
+  if (format!=compression::none) {
+    decompressing_istream in {file.begin(),file.end(),format};
+    return read_uncompressed(in);
+  }
+  if (is_cnf_cache(file.begin(),file.end()))
+    return formula_statistics(read_cnf_cache(file.begin(),file.end()));
+  return dimacs_statistics(file.begin(),file.end(),threads);
+}
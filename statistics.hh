@@ -0,0 +1,96 @@
+/*
+  Copyright (C) 2026 by Massimo Lauria <lauria.massimo@gmail.com>
+
+  Created   : "2026-10-18, Sunday 21:10 (CEST) Massimo Lauria"
+  Time-stamp: "2026-10-18, 21:10 (CEST) Massimo Lauria"
+
+  Description::
+
+  Statistics of CNF formulas.
+
+  A `cnf_statistics` object describes the shape of a formula: the
+  histogram of the widths of its clauses and the number of
+  occurrences of each literal. Everything else (units, binary
+  clauses, largest and mean width, polarity of the variables...) is
+  derived from these two arrays.
+
+  The statistics of a dimacs file are computed in a single pass over
+  the input, and the clauses are never stored:
+
+     cnf_statistics s {load_statistics_file("formula.cnf",8)};
+     s.widths[3];                  // number of clauses of width 3
+     s.positive(7);                // occurrences of literal 7
+     s.negative(7);                // occurrences of literal -7
+
+  As for `load_cnf_file` (see `cnf_cache.hh`), the input can be a
+  dimacs file or a binary cache, possibly compressed, and the same
+  parser exceptions are thrown on bad input. A dimacs file in memory
+  is scanned on several threads, cut in pieces at clause boundaries
+  as in `parse_dimacs`. Each thread counts the occurrences in an
+  array of its own, so the memory used is 16 bytes per variable per
+  thread.
+
+  The size of the output of cnf2kcnf only depends on the widths of the
+  clauses, so it can be predicted from the statistics (see
+  `kcnf_output_size` in `cnftools.hh`).
+*/
+
+#ifndef _STATISTICS_HH_
+#define _STATISTICS_HH_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cnf.hh"
+
+
+struct cnf_statistics {
+
+  variable variables;                 // as declared
+  size_t   clauses;
+  size_t   literals;                  // occurrences, in total
+  std::vector<size_t>   widths;       // clauses of each width
+  std::vector<uint64_t> occurrences;  // of each literal, by packed index
+
+  cnf_statistics(variable n=0);
+
+  uint64_t positive(variable v) const { return occurrences[packed_literal{v,true}.index()]; }
+  uint64_t negative(variable v) const { return occurrences[packed_literal{v,false}.index()]; }
+
+  size_t units()     const { return widths.size()>1 ? widths[1] : 0; }
+  size_t binaries()  const { return widths.size()>2 ? widths[2] : 0; }
+  size_t max_width() const { return widths.empty() ? 0 : widths.size()-1; }
+  double mean_width() const {
+    return clauses==0 ? 0.0 : static_cast<double>(literals)/clauses;
+  }
+
+  // count a clause
+  void add_clause(clause_view c);
+  void add_clause(const packed_clause& c);
+
+  // add the counts of `other`, on the same variables
+  void merge(const cnf_statistics& other);
+};
+
+
+class dimacs_reader;
+
+// Statistics of a formula in memory.
+cnf_statistics formula_statistics(const cnf& F);
+
+// Statistics of the dimacs formula read by `reader`.
+cnf_statistics dimacs_statistics(dimacs_reader& reader);
+
+// Statistics of the dimacs formula in [begin,end), using several
+// threads.
+cnf_statistics dimacs_statistics(const char* begin,const char* end,unsigned int threads=1);
+
+// Statistics of the formula in the file at `path` or in a stream: a
+// binary cache or a dimacs file, possibly compressed.
+cnf_statistics load_statistics_file(const std::string& path,unsigned int threads=1);
+cnf_statistics read_statistics(std::istream& in);
+
+
+#endif /* _STATISTICS_HH_ */
@@ -9,6 +9,11 @@
 
 // Preamble
 
+#include <algorithm>
+#include <climits>
+#include <set>
+#include <sstream>
+
 #include "testbasic.hh"
 #include "cnftools.hh"
 
@@ -56,3 +61,525 @@ void TestBasic::test_clause_addition() {
   CPPUNIT_ASSERT_MESSAGE("Clause addition which raise an exception must be rolled back",a.variables_number()==5);
 }
 
+
+void TestBasic::test_clause_access() {
+  cnf a { {-1, 3,-2,4},
+          {},
+          { 5, 3,-1} };
+
+  CPPUNIT_ASSERT(a.size()==3);
+  CPPUNIT_ASSERT(a.literals_number()==7);
+  CPPUNIT_ASSERT(a[0]==clause({-1,3,-2,4}));
+  CPPUNIT_ASSERT(a[1].empty());
+  CPPUNIT_ASSERT(a[2][1]==3);
+
+  size_t i {0};
+  for (auto c : a) {
+    CPPUNIT_ASSERT_MESSAGE("Iteration and indexing must agree",c==a[i]);
+    ++i;
+  }
+  CPPUNIT_ASSERT(i==a.size());
+  CPPUNIT_ASSERT(a.end()-a.begin()==3);
+
+  // a clause of the formula can be added again to the formula itself
+  for (int j=0; j<20; ++j) a.add_clause(a[0]);
+  CPPUNIT_ASSERT(a.size()==23);
+  CPPUNIT_ASSERT_MESSAGE("Self addition must copy the right literals",a[22]==a[0]);
+
+  // copies are independent, moved objects are left empty
+  cnf b {a};
+  b.add_clause({1});
+  CPPUNIT_ASSERT(a!=b);
+  cnf c {std::move(b)};
+  CPPUNIT_ASSERT(c.size()==24);
+  CPPUNIT_ASSERT(b.size()==0);
+}
+
+void TestBasic::test_random_formulas() {
+  cnf a {random_kcnf(20,100,3,7)};
+  CPPUNIT_ASSERT(a.variables_number()==20);
+  CPPUNIT_ASSERT(a.size()==100);
+  CPPUNIT_ASSERT(a.literals_number()==300);
+  for (auto c : a)
+    for (auto lit : c)
+      CPPUNIT_ASSERT(lit!=0 && lit>=-20 && lit<=20);
+
+  // same seed, same formula, on every platform
+  CPPUNIT_ASSERT(a[0]==clause({-3,-14,2}));
+  CPPUNIT_ASSERT(a[99]==clause({14,13,6}));
+  CPPUNIT_ASSERT(a==random_kcnf(20,100,3,7));
+  CPPUNIT_ASSERT(a!=random_kcnf(20,100,3,8));
+
+  cnf b {random_wide_cnf(50,200,30,7)};
+  CPPUNIT_ASSERT(b.size()==200);
+  size_t widest {0};
+  for (auto c : b) {
+    CPPUNIT_ASSERT(c.size()>=1 && c.size()<=30);
+    widest = std::max(widest,c.size());
+  }
+  CPPUNIT_ASSERT(widest>20);
+  CPPUNIT_ASSERT(b==random_wide_cnf(50,200,30,7));
+
+  CPPUNIT_ASSERT_THROW(random_kcnf(0,10,3,1),std::invalid_argument);
+}
+
+
+void TestBasic::test_simplify() {
+  cnf a {6};
+  a.add_clause({3,-1,2});
+  a.add_clause({2,-4,2,2});       // repeated literals
+  a.add_clause({1,5,-1});         // tautology
+  a.add_clause({2,-1,3});         // same as the first one
+  a.add_clause({});
+  a.add_clause({-4,2});           // same as the second one
+  a.add_clause({-3,3,3});         // tautology with repetitions
+  a.add_clause({});
+
+  simplify_stats stats;
+  cnf b {simplify(a,stats)};
+  cnf expected { {-1,2,3}, {2,-4}, {} };
+  expected.update_variables(6);
+  CPPUNIT_ASSERT(b==expected);
+  CPPUNIT_ASSERT(stats.duplicate_literals==2);
+  CPPUNIT_ASSERT(stats.tautologies==2);
+  CPPUNIT_ASSERT(stats.duplicate_clauses==3);
+
+  // the result is a fixed point
+  CPPUNIT_ASSERT(simplify(b,stats)==b);
+  CPPUNIT_ASSERT(stats.duplicate_literals==0 && stats.tautologies==0 &&
+                 stats.duplicate_clauses==0);
+
+  // many clauses: each one of the formula is repeated, in reverse
+  cnf c {random_kcnf(30,2000,4,3)};
+  simplify_stats first;
+  cnf d {simplify(c,first)};
+  cnf e {c};
+  for (auto cla : c) e.add_clause(clause(cla.begin(),cla.end()));
+  for (size_t i=0; i<c.size(); ++i) {
+    clause reversed(c[i].begin(),c[i].end());
+    std::reverse(reversed.begin(),reversed.end());
+    e.add_clause(reversed);
+  }
+  CPPUNIT_ASSERT(simplify(e,stats)==d);
+  CPPUNIT_ASSERT(stats.tautologies==3*first.tautologies);
+  CPPUNIT_ASSERT(stats.duplicate_clauses==2*d.size()+3*first.duplicate_clauses);
+  for (auto cla : d) {
+    CPPUNIT_ASSERT(std::is_sorted(cla.begin(),cla.end(),
+                                  [](literal x,literal y) { return abs(x)<abs(y); }));
+    for (size_t i=1; i<cla.size(); ++i) CPPUNIT_ASSERT(abs(cla[i-1])!=abs(cla[i]));
+  }
+}
+
+
+// occurrences of each literal, by scanning the formula
+static vector<clause_id> scan_occurrences(const cnf& F,literal lit) {
+  vector<clause_id> result;
+  for (size_t i=0; i<F.size(); ++i)
+    for (auto l : F[i])
+      if (l==lit) result.push_back(static_cast<clause_id>(i));
+  return result;
+}
+
+static bool same_occurrences(const cnf& F,const occurrence_list& occurs) {
+  for (variable v=1; v<=F.variables_number(); ++v)
+    for (literal lit : {v,-v}) {
+      auto view = occurs[lit];
+      if (vector<clause_id>(view.begin(),view.end())!=scan_occurrences(F,lit))
+        return false;
+    }
+  return occurs.size()==F.literals_number();
+}
+
+void TestBasic::test_occurrences() {
+  cnf a { {1,-2,3}, {-1,2}, {}, {2,3,-4}, {-2} };
+  occurrence_list occurs {a};
+  CPPUNIT_ASSERT(occurs.variables_number()==4);
+  CPPUNIT_ASSERT(occurs.clauses_number()==5);
+  CPPUNIT_ASSERT(occurs[-2].size()==2 && occurs[-2][0]==0 && occurs[-2][1]==4);
+  CPPUNIT_ASSERT(occurs[4].empty());
+  CPPUNIT_ASSERT(occurs[7].empty());
+  CPPUNIT_ASSERT(occurs[0].empty());
+  CPPUNIT_ASSERT(same_occurrences(a,occurs));
+
+  // incremental updates, also with new variables, force buckets
+  // to move and the array to be compacted
+  cnf b {random_kcnf(40,3000,3,11)};
+  for (size_t i=0; i<3000; i+=2) a.add_clause(b[i]);
+  occurs.update(a);
+  CPPUNIT_ASSERT(occurs.clauses_number()==a.size());
+  CPPUNIT_ASSERT(same_occurrences(a,occurs));
+  for (size_t i=1; i<3000; i+=2) {
+    a.add_clause(b[i]);
+    occurs.update(a);
+  }
+  CPPUNIT_ASSERT(same_occurrences(a,occurs));
+  CPPUNIT_ASSERT(occurrence_list{a}.size()==occurs.size());
+
+  // removal keeps the order of the other occurrences
+  occurs.remove(0,a[0]);
+  occurs.remove(4,a[4]);
+  occurs.remove(4,a[4]);
+  CPPUNIT_ASSERT(occurs.size()==a.literals_number()-4);
+  auto view = occurs[-2];
+  CPPUNIT_ASSERT(view.empty() || view[0]>4);
+  CPPUNIT_ASSERT(std::is_sorted(view.begin(),view.end()));
+
+  occurrence_list empty {};
+  empty.add(3,{5,-1});
+  CPPUNIT_ASSERT(empty.variables_number()==5);
+  CPPUNIT_ASSERT(empty[5].size()==1 && empty[5][0]==3);
+  CPPUNIT_ASSERT_THROW(empty.add(4,{2,0}),std::domain_error);
+}
+
+
+// value of F under the assignment whose bit i-1 is the value of
+// variable i
+static bool evaluate(const cnf& F,unsigned long assignment) {
+  for (auto c : F) {
+    bool satisfied {false};
+    for (auto lit : c)
+      satisfied = satisfied || (((assignment >> (abs(lit)-1)) & 1) == (lit>0));
+    if (!satisfied) return false;
+  }
+  return true;
+}
+
+static bool equivalent(const cnf& F,const cnf& G) {
+  if (F.variables_number()!=G.variables_number()) return false;
+  for (unsigned long a=0; a < (1UL << F.variables_number()); ++a)
+    if (evaluate(F,a)!=evaluate(G,a)) return false;
+  return true;
+}
+
+static bool brute_force_satisfiable(const cnf& F) {
+  for (unsigned long a=0; a < (1UL << F.variables_number()); ++a)
+    if (evaluate(F,a)) return true;
+  return false;
+}
+
+void TestBasic::test_subsume() {
+  cnf a { {1,2,3}, {3,2,1,4}, {-1,2}, {1,2,-5}, {2,4,5}, {5,-4,2} };
+  subsume_stats stats;
+  cnf b {subsume(a,stats)};
+  // (-1 2) and (1 2 3) give (2 3), (-1 2) and (1 2 -5) give (2 -5),
+  // which subsumes nothing but then (2 -5) with (2 5 -4) gives (2 -4),
+  // and (2 -4) with (2 4 5) gives (2 5), which with (2 -5) gives (2)
+  cnf expected { {2} };
+  expected.update_variables(5);
+  CPPUNIT_ASSERT(b==expected);
+  CPPUNIT_ASSERT(stats.simplified.duplicate_clauses==0);
+  CPPUNIT_ASSERT(stats.subsumed_clauses+b.size()+stats.simplified.tautologies==a.size());
+
+  // the empty clause subsumes everything
+  cnf c {subsume({ {1,-2}, {3}, {-3}, {2,4} })};
+  CPPUNIT_ASSERT(c.size()==1 && c[0].empty() && c.variables_number()==4);
+
+  // random formulas: the result is equivalent, and a fixed point
+  for (uint64_t seed=1; seed<=30; ++seed) {
+    cnf F {random_wide_cnf(10,40,5,seed)};
+    cnf G {subsume(F,stats)};
+    CPPUNIT_ASSERT(equivalent(F,G));
+    CPPUNIT_ASSERT(subsume(G,stats)==G);
+    CPPUNIT_ASSERT(stats.subsumed_clauses==0 && stats.strengthened_literals==0);
+  }
+}
+
+
+void TestBasic::test_packed_literals() {
+  static_assert(packed_literal{1}.index()==0 && packed_literal{-1}.index()==1,
+                "literals of variable 1 come first");
+  static_assert((~packed_literal{-7}).dimacs()==7, "negation");
+  static_assert(topacked(4,false)==packed_literal{-4}, "sign convention");
+
+  for (literal lit=-1000; lit<=1000; ++lit) {
+    if (lit==null_literal) continue;
+    packed_literal p {lit};
+    CPPUNIT_ASSERT(p.dimacs()==lit);
+    CPPUNIT_ASSERT(p.var()==abs(lit) && p.negative()==(lit<0));
+    CPPUNIT_ASSERT(p.index()==2*static_cast<uint32_t>(abs(lit)-1)+(lit<0));
+    CPPUNIT_ASSERT((~p).dimacs()==-lit && ~~p==p);
+    CPPUNIT_ASSERT(packed_literal::from_index(p.index())==p);
+  }
+  CPPUNIT_ASSERT(packed_literal{INT_MAX}.dimacs()==INT_MAX);
+  CPPUNIT_ASSERT(packed_literal{-INT_MAX}.dimacs()==-INT_MAX);
+
+  // the reader and the writer map packed clauses from and to dimacs
+  std::string text {"p cnf 12 2\n-12 3 1 0\n-5 0\n"};
+  dimacs_reader reader {text.data(),text.data()+text.size()};
+  variable n;
+  cnf::size_type m;
+  packed_clause c;
+  reader.read_spec(n,m);
+  CPPUNIT_ASSERT(reader.read_clause(c)==12);
+  CPPUNIT_ASSERT(c.size()==3 && c[0]==packed_literal{-12} && c[2]==packed_literal{1});
+
+  std::ostringstream out;
+  {
+    dimacs_writer writer {out};
+    writer.write_spec(12,2);
+    writer.write_clause(c);
+    CPPUNIT_ASSERT(reader.read_clause(c)==5);
+    writer.write_clause(c);
+  }
+  CPPUNIT_ASSERT(out.str()==text);
+
+  occurrence_list occurs { cnf{ {1,-2}, {2,-1}, {-2} } };
+  CPPUNIT_ASSERT(occurs[packed_literal{-2}].size()==2 && occurs[~packed_literal{-2}].size()==1);
+}
+
+
+void TestBasic::test_eliminate() {
+  // y is defined as (1 and 2), and it is used in two clauses
+  cnf a { {-6,1}, {-6,2}, {6,-1,-2}, {6,3}, {6,4,-5} };
+  elimination_stack stack;
+  eliminate_stats stats;
+  eliminate_options options;
+  options.max_occurrences = 3;
+  cnf b {eliminate(a,options,stack,stats)};
+  for (auto c : b)
+    for (auto lit : c) CPPUNIT_ASSERT(abs(lit)!=6);
+  CPPUNIT_ASSERT(b.variables_number()==6 && b.size()<=a.size());
+  CPPUNIT_ASSERT(stats.eliminated_variables>=1);
+  CPPUNIT_ASSERT(a.size()-stats.removed_clauses+stats.added_clauses==b.size());
+  // each clause of the stack starts with an eliminated variable
+  CPPUNIT_ASSERT(stack.size()>=stats.eliminated_variables);
+  for (size_t i=0; i<stack.size(); ++i) {
+    CPPUNIT_ASSERT(!stack[i].empty());
+    for (auto c : b)
+      for (auto lit : c) CPPUNIT_ASSERT(abs(lit)!=abs(stack[i][0]));
+  }
+
+  // all the resolvents of 1 and 2 are the empty clause
+  cnf e {eliminate({ {1,2}, {1,-2}, {-1,2}, {-1,-2}, {3,4} },{},stack,stats)};
+  CPPUNIT_ASSERT(stats.conflict);
+  CPPUNIT_ASSERT(e.size()==1 && e[0].empty() && e.variables_number()==4);
+  e = eliminate({ {1,2}, {}, {-1,3} },{},stack,stats);
+  CPPUNIT_ASSERT(stats.conflict && e.size()==1 && e[0].empty());
+  eliminate(a,options,stack,stats);
+  CPPUNIT_ASSERT(!stats.conflict);
+
+  // the resolvents are not wider than the bound: on a satisfiable
+  // 3-CNF with some binary clauses, only the resolvents with a binary
+  // clause are allowed
+  options.max_occurrences = 100;
+  options.max_resolvent_width = 3;
+  cnf c {random_kcnf(100,200,3,3)};
+  for (auto cl : random_kcnf(100,60,2,1003)) c.add_clause(cl);
+  cnf d {eliminate(c,options,stack,stats)};
+  CPPUNIT_ASSERT(stats.eliminated_variables>0 && stats.added_clauses>0);
+  auto literals = [](clause_view cl) {
+    vector<literal> sorted(cl.begin(),cl.end());
+    std::sort(sorted.begin(),sorted.end());
+    sorted.erase(std::unique(sorted.begin(),sorted.end()),sorted.end());
+    return sorted;
+  };
+  std::set<vector<literal>> original;
+  for (auto cl : c) original.insert(literals(cl));
+  for (auto cl : d) {
+    CPPUNIT_ASSERT(!cl.empty());
+    if (original.count(literals(cl))==0) CPPUNIT_ASSERT(literals(cl).size()<=3);
+  }
+
+  // random formulas: the result is equisatisfiable, and each model of
+  // it extends to a model of the original formula
+  for (uint64_t seed=1; seed<=40; ++seed) {
+    cnf F {random_kcnf(10,20+seed%30,3,seed)};
+    if (seed%3==0) F.add_clause({static_cast<literal>(seed%10)+1});
+    elimination_stack extension;
+    cnf G {eliminate(F,{},extension,stats)};
+    CPPUNIT_ASSERT(G.variables_number()==F.variables_number());
+    CPPUNIT_ASSERT(G.size()<=F.size());
+
+    CPPUNIT_ASSERT(brute_force_satisfiable(F)==brute_force_satisfiable(G));
+    for (unsigned long x=0; x < (1UL << F.variables_number()); ++x) {
+      if (!evaluate(G,x)) continue;
+      std::vector<bool> model(F.variables_number()+1,false);
+      for (variable v=1; v<=F.variables_number(); ++v) model[v] = (x >> (v-1)) & 1;
+      extension.extend(model);
+      unsigned long y {0};
+      for (variable v=1; v<=F.variables_number(); ++v) y |= static_cast<unsigned long>(model[v]) << (v-1);
+      CPPUNIT_ASSERT(evaluate(F,y));
+    }
+  }
+}
+
+
+void TestBasic::test_propagate() {
+  // 1 and 2 are forced, then 3 is pure, and without its clauses -4 is
+  // pure too
+  cnf a { {1}, {-1,2}, {-2,3,4}, {-4,5}, {3,-5,6} };
+  vector<literal> assigned;
+  propagate_stats stats;
+  cnf b {propagate(a,assigned,stats)};
+  CPPUNIT_ASSERT(b.size()==0 && b.variables_number()==6);
+  CPPUNIT_ASSERT((assigned==vector<literal>{1,2,3,-4}));
+  CPPUNIT_ASSERT(stats.units==2 && stats.pure_literals==2 && !stats.conflict);
+  CPPUNIT_ASSERT(stats.satisfied_clauses==5 && stats.false_literals==1);
+
+  // the propagation falsifies (-2 -3)
+  cnf c {propagate({ {1}, {-1,2}, {-2,-3}, {3,-1}, {4,5} },assigned,stats)};
+  CPPUNIT_ASSERT(stats.conflict);
+  CPPUNIT_ASSERT(c.size()==1 && c[0].empty() && c.variables_number()==5);
+
+  // random formulas: the result has no units, and its models together
+  // with the assignment are the models of the original formula
+  for (uint64_t seed=1; seed<=40; ++seed) {
+    cnf F {random_kcnf(10,10+seed%30,3,seed)};
+    for (uint64_t i=0; i<seed%4; ++i) F.add_clause({static_cast<literal>((seed+i)%10)+1});
+    F.add_clause({-static_cast<literal>(seed%7)-1,static_cast<literal>(seed%5)+4});
+    cnf G {propagate(F,assigned,stats)};
+    CPPUNIT_ASSERT(G.variables_number()==F.variables_number());
+
+    unsigned long mask {0}, fixed {0};
+    for (literal lit : assigned) {
+      mask  |= 1UL << (abs(lit)-1);
+      fixed |= static_cast<unsigned long>(lit>0) << (abs(lit)-1);
+    }
+    CPPUNIT_ASSERT(brute_force_satisfiable(F)==brute_force_satisfiable(G));
+    for (unsigned long x=0; x < (1UL << F.variables_number()); ++x)
+      if (evaluate(G,x)) CPPUNIT_ASSERT(evaluate(F,(x & ~mask) | fixed));
+    if (stats.conflict) continue;
+    for (auto cl : G) {
+      CPPUNIT_ASSERT(cl.size()>=2);
+      for (auto lit : cl) CPPUNIT_ASSERT(((mask >> (abs(lit)-1)) & 1)==0);
+    }
+  }
+}
+
+
+void TestBasic::test_equivalences() {
+  // 1, 2 and 3 are equivalent, and 5 is equivalent to -4
+  cnf a { {-1,2}, {1,-2}, {2,-3}, {-2,3}, {4,5}, {-4,-5}, {3,4,6}, {-2,-5,6}, {1,-6} };
+  vector<literal> representative;
+  equivalence_stats stats;
+  cnf b {substitute_equivalences(a,representative,stats)};
+  CPPUNIT_ASSERT((representative==vector<literal>{0,1,1,1,4,-4,6}));
+  CPPUNIT_ASSERT(stats.substituted_variables==3 && !stats.conflict);
+  cnf expected { {1,4,6}, {-1,4,6}, {1,-6} };
+  CPPUNIT_ASSERT(b==expected);
+
+  // 1 implies 2, 2 implies -1, -1 implies -2 and -2 implies 1
+  cnf c {substitute_equivalences({ {-1,2}, {-2,-1}, {1,2}, {1,-2}, {3,4} },representative,stats)};
+  CPPUNIT_ASSERT(stats.conflict);
+  CPPUNIT_ASSERT(c.size()==1 && c[0].empty() && c.variables_number()==4);
+
+  // random formulas with many binary clauses: the result is
+  // equisatisfiable, and the representatives extend its models
+  for (uint64_t seed=1; seed<=40; ++seed) {
+    cnf F {random_kcnf(10,5+seed%10,3,seed)};
+    cnf B {random_kcnf(10,8+seed%8,2,seed+1000)};
+    for (auto cl : B) F.add_clause(cl);
+    cnf G {substitute_equivalences(F,representative,stats)};
+    CPPUNIT_ASSERT(G.variables_number()==F.variables_number());
+
+    CPPUNIT_ASSERT(brute_force_satisfiable(F)==brute_force_satisfiable(G));
+    for (unsigned long x=0; x < (1UL << F.variables_number()); ++x) {
+      if (!evaluate(G,x)) continue;
+      unsigned long y {0};
+      for (variable v=1; v<=F.variables_number(); ++v) {
+        literal r {representative[v]};
+        y |= static_cast<unsigned long>(((x >> (abs(r)-1)) & 1) == (r>0)) << (v-1);
+      }
+      CPPUNIT_ASSERT(evaluate(F,y));
+    }
+    if (stats.conflict) continue;
+    for (auto cl : G)
+      for (auto lit : cl) CPPUNIT_ASSERT(representative[abs(lit)]==abs(lit));
+  }
+}
+
+
+void TestBasic::test_components() {
+  // {2,5,7}, {3,4} and {6}, where 1 does not occur
+  cnf a { {2,-5}, {3,4}, {-6}, {5,7}, {}, {-4,-3,3} };
+  a.update_variables(8);
+  auto parts = split_components(a);
+  CPPUNIT_ASSERT(parts.size()==4);
+  CPPUNIT_ASSERT((parts[0].variables==vector<variable>{2,5,7}));
+  CPPUNIT_ASSERT((parts[0].formula==cnf{ {1,-2}, {2,3} }));
+  CPPUNIT_ASSERT((parts[1].variables==vector<variable>{3,4}));
+  CPPUNIT_ASSERT((parts[1].formula==cnf{ {1,2}, {-2,-1,1} }));
+  CPPUNIT_ASSERT((parts[2].variables==vector<variable>{6}));
+  CPPUNIT_ASSERT((parts[2].formula==cnf{ {-1} }));
+  CPPUNIT_ASSERT(parts[3].variables.empty() && parts[3].formula.size()==1);
+  CPPUNIT_ASSERT(parts[3].formula[0].empty() && parts[3].formula.variables_number()==0);
+
+  std::ostringstream map;
+  write_variable_map(map,parts[0].variables);
+  CPPUNIT_ASSERT(map.str()=="1 2\n2 5\n3 7\n");
+
+  // random formulas: components share no variable, and together they
+  // have all the clauses, renamed back
+  for (uint64_t seed=1; seed<=20; ++seed) {
+    cnf F {random_kcnf(200,40+seed*5,2+seed%3,seed)};
+    auto components = split_components(F);
+    cnf G {F.variables_number()};
+    vector<int> owner(F.variables_number()+1,-1);
+    size_t clauses {0};
+    for (size_t i=0; i<components.size(); ++i) {
+      auto& C = components[i];
+      CPPUNIT_ASSERT(C.formula.variables_number()==static_cast<variable>(C.variables.size()));
+      for (variable v : C.variables) {
+        CPPUNIT_ASSERT(owner[v]<0);
+        owner[v] = static_cast<int>(i);
+      }
+      clauses += C.formula.size();
+    }
+    CPPUNIT_ASSERT(clauses==F.size());
+    for (auto cl : F)
+      for (auto lit : cl) CPPUNIT_ASSERT(owner[abs(lit)]==owner[abs(cl[0])]);
+    for (size_t i=0; i<components.size(); ++i) {
+      size_t j {0};
+      for (auto cl : F) {
+        if (owner[abs(cl[0])]!=static_cast<int>(i)) continue;
+        clause_view c {components[i].formula[j++]};
+        CPPUNIT_ASSERT(c.size()==cl.size());
+        for (size_t l=0; l<c.size(); ++l)
+          CPPUNIT_ASSERT((c[l]>0 ? 1 : -1)*components[i].variables[abs(c[l])-1]==cl[l]);
+      }
+    }
+  }
+}
+
+
+void TestBasic::test_renumber() {
+  cnf a { {9,-4}, {2,7}, {-7,4,12} };
+  a.update_variables(20);
+  vector<variable> original;
+  cnf b {renumber(a,original)};
+  CPPUNIT_ASSERT((original==vector<variable>{2,4,7,9,12}));
+  CPPUNIT_ASSERT((b==cnf{ {4,-2}, {1,3}, {-3,2,5} }));
+  CPPUNIT_ASSERT(b.variables_number()==5);
+
+  // the search from 2 reaches 7, then 4 and 12, then 9. Cuthill-McKee
+  // visits 12 before 4, which has more occurrences
+  b = renumber(a,original,variable_order::bfs);
+  CPPUNIT_ASSERT((original==vector<variable>{2,7,4,12,9}));
+  b = renumber(a,original,variable_order::reverse_cuthill_mckee);
+  CPPUNIT_ASSERT((original==vector<variable>{9,4,12,7,2}));
+  CPPUNIT_ASSERT((b==cnf{ {1,-2}, {5,4}, {-4,2,3} }));
+
+  // random formulas with unused variables: the result is the same
+  // formula, renamed
+  for (uint64_t seed=1; seed<=20; ++seed) {
+    cnf F {random_kcnf(300,50+seed*10,3,seed)};
+    for (auto order : {variable_order::compact, variable_order::bfs,
+                       variable_order::reverse_cuthill_mckee}) {
+      cnf G {renumber(F,original,order)};
+      CPPUNIT_ASSERT(G.variables_number()==static_cast<variable>(original.size()));
+      CPPUNIT_ASSERT(G.size()==F.size());
+      vector<bool> used(F.variables_number()+1,false);
+      for (variable v : original) {
+        CPPUNIT_ASSERT(v>=1 && v<=F.variables_number() && !used[v]);
+        used[v] = true;
+      }
+      for (size_t i=0; i<F.size(); ++i) {
+        CPPUNIT_ASSERT(G[i].size()==F[i].size());
+        for (size_t l=0; l<F[i].size(); ++l) {
+          literal lit {G[i][l]};
+          CPPUNIT_ASSERT((lit>0 ? 1 : -1)*original[abs(lit)-1]==F[i][l]);
+        }
+      }
+    }
+  }
+}
@@ -22,6 +22,17 @@ class TestBasic : public CppUnit::TestFixture  {
   CPPUNIT_TEST_SUITE( TestBasic );
   CPPUNIT_TEST( test_list_constructor );
   CPPUNIT_TEST( test_clause_addition );
+  CPPUNIT_TEST( test_clause_access );
+  CPPUNIT_TEST( test_random_formulas );
+  CPPUNIT_TEST( test_simplify );
+  CPPUNIT_TEST( test_occurrences );
+  CPPUNIT_TEST( test_subsume );
+  CPPUNIT_TEST( test_packed_literals );
+  CPPUNIT_TEST( test_eliminate );
+  CPPUNIT_TEST( test_propagate );
+  CPPUNIT_TEST( test_equivalences );
+  CPPUNIT_TEST( test_components );
+  CPPUNIT_TEST( test_renumber );
   CPPUNIT_TEST_SUITE_END();
  
 public:
@@ -29,6 +40,17 @@ public:
   virtual void tearDown();
   virtual void test_list_constructor();
   virtual void test_clause_addition();
+  virtual void test_clause_access();
+  virtual void test_random_formulas();
+  virtual void test_simplify();
+  virtual void test_occurrences();
+  virtual void test_subsume();
+  virtual void test_packed_literals();
+  virtual void test_eliminate();
+  virtual void test_propagate();
+  virtual void test_equivalences();
+  virtual void test_components();
+  virtual void test_renumber();
 };
 
 
@@ -11,7 +11,8 @@
 */
 
 // Preamble
-
+#include <sstream>
+#include <string>
 
 #include "cnftools.hh"
 #include "testcnf2kcnf.hh"
@@ -73,3 +74,203 @@ void TestCnf2kcnf::test_to4cnf()
     CPPUNIT_ASSERT_MESSAGE("Conversion from 5-cnf from 4-cnf",cnf2kcnf(d, 4)==e);
 
   }
+
+
+void TestCnf2kcnf::test_streaming()
+  {
+    std::string data {"c clauses of several widths\n"
+                      "p cnf 9 6\n"
+                      "1 2 3 4 5 6 7 8 9 0\n"
+                      "-1 0\n"
+                      "0\n"
+                      "3 -4 5 0\n"
+                      "-9 -8 -7 -6 0\n"
+                      "2 4 6 8 -1 -3 -5 0\n"};
+
+    for (size_t k=3; k<10; ++k) {
+      std::ostringstream expected, streamed;
+      expected<<cnf2kcnf(parse_dimacs(data),k);
+      cnf2kcnf_stream(data.data(),data.data()+data.size(),k,streamed);
+      CPPUNIT_ASSERT_MESSAGE("Streaming conversion must print the same formula",
+                             expected.str()==streamed.str());
+    }
+
+    std::ostringstream out;
+    std::string bad {"p cnf 3 2\n1 2 3 4 0\n1 0\n"};
+    CPPUNIT_ASSERT_THROW(cnf2kcnf_stream(bad.data(),bad.data()+bad.size(),3,out),
+                         dimacs_bad_value);
+    CPPUNIT_ASSERT_MESSAGE("No output on bad input",out.str().empty());
+  }
+
+
+void TestCnf2kcnf::test_parallel()
+  {
+    // clauses of width 0..19 on 20 variables, in a fixed mixed order
+    cnf a {20};
+    for (int i=0; i<200; ++i) {
+      clause c;
+      for (int j=0; j<(i*7)%20; ++j) c.push_back(toliteral(1+(i+j)%20,(i+j)%3==0));
+      a.add_clause(c);
+    }
+
+    for (size_t k=3; k<8; ++k) {
+      cnf expected {cnf2kcnf(a,k)};
+      for (unsigned int threads=1; threads<=9; ++threads)
+        CPPUNIT_ASSERT_MESSAGE("Parallel conversion must give the same formula",
+                               cnf2kcnf(a,k,threads)==expected);
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Parallel conversion of the empty formula",
+                           cnf2kcnf(cnf{3},3,4)==cnf{3});
+  }
+
+
+// F is satisfiable, by brute force
+static bool satisfiable(const cnf& F) {
+  for (unsigned long a=0; a < (1UL << F.variables_number()); ++a) {
+    bool all {true};
+    for (auto c : F) {
+      bool some {false};
+      for (auto lit : c) some = some || (((a >> (abs(lit)-1)) & 1) == (lit>0));
+      all = all && some;
+    }
+    if (all) return true;
+  }
+  return false;
+}
+
+void TestCnf2kcnf::test_tree_split()
+  {
+    // the encoding of each width has the announced size and width
+    for (size_t k=3; k<8; ++k)
+      for (size_t w=0; w<70; ++w) {
+        clause c;
+        for (size_t i=1; i<=w; ++i) c.push_back(static_cast<literal>(i));
+        cnf a {static_cast<variable>(w)};
+        a.add_clause(c);
+        cnf b {cnf2kcnf(a,k,split_strategy::tree)};
+        auto size = tree_split::size(w,k);
+        CPPUNIT_ASSERT(b.variables_number()==static_cast<variable>(w)+size.variables);
+        CPPUNIT_ASSERT(b.size()==size.clauses && b.literals_number()==size.literals);
+        for (auto d : b) CPPUNIT_ASSERT(d.size()<=k);
+        CPPUNIT_ASSERT(size.variables<=chain_split::size(w,k).variables);
+      }
+
+    // equisatisfiable under every assignment of the original variables
+    for (int mask=0; mask<128; ++mask) {
+      cnf a { {1,-2,3,4,-5,6,7} };
+      for (variable v=1; v<=7; ++v) a.add_clause({toliteral(v,(mask>>(v-1))&1)});
+      cnf b {cnf2kcnf(a,3,split_strategy::tree)};
+      CPPUNIT_ASSERT(satisfiable(a)==satisfiable(b));
+    }
+
+    // parallel and streaming conversions give the same formula
+    cnf a {random_wide_cnf(30,300,40,5)};
+    std::ostringstream text;
+    text<<a;
+    for (size_t k=3; k<7; ++k) {
+      cnf expected {cnf2kcnf(a,k,split_strategy::tree)};
+      CPPUNIT_ASSERT(expected!=cnf2kcnf(a,k));
+      for (unsigned int threads=2; threads<=5; ++threads)
+        CPPUNIT_ASSERT(cnf2kcnf(a,k,threads,split_strategy::tree)==expected);
+      std::ostringstream printed, streamed;
+      printed<<expected;
+      std::string data {text.str()};
+      cnf2kcnf_stream(data.data(),data.data()+data.size(),k,streamed,split_strategy::tree);
+      CPPUNIT_ASSERT(printed.str()==streamed.str());
+    }
+  }
+
+
+void TestCnf2kcnf::test_factoring()
+  {
+    // the same "at least one" constraint with different side literals
+    cnf a {40};
+    clause c;
+    for (literal lit=1; lit<=32; ++lit) c.push_back(lit);
+    for (literal side=33; side<=40; ++side) {
+      c.push_back(-side);
+      a.add_clause(c);
+      c.pop_back();
+    }
+    cnf tree {cnf2kcnf(a,3,split_strategy::tree)};
+    cnf factored {cnf2kcnf_factored(a,3)};
+    for (auto d : factored) CPPUNIT_ASSERT(d.size()<=3);
+    CPPUNIT_ASSERT(factored.size()*4 < tree.size());
+    CPPUNIT_ASSERT(factored.variables_number()-40 < (tree.variables_number()-40)/4);
+
+    // without repeated groups the encoding is as large as the tree
+    cnf b { {1,2,3,4,5,6,7}, {-1,-2,-3,-4,-5} };
+    CPPUNIT_ASSERT(cnf2kcnf_factored(b,3).size()==cnf2kcnf(b,3,split_strategy::tree).size());
+    CPPUNIT_ASSERT(cnf2kcnf_factored(b,4).variables_number()==
+                   cnf2kcnf(b,4,split_strategy::tree).variables_number());
+
+    // equisatisfiable under every assignment of the original
+    // variables: groups are shared in the same clause and among
+    // clauses, also with their literals in another order
+    for (int mask=0; mask<64; ++mask) {
+      cnf d { {1,2,3,4,-5,6}, {2,1,4,3,5,-6}, {3,4,1,2,3,4} };
+      for (variable v=1; v<=6; ++v) d.add_clause({toliteral(v,(mask>>(v-1))&1)});
+      cnf e {cnf2kcnf_factored(d,3)};
+      CPPUNIT_ASSERT(e.variables_number()<=14);
+      CPPUNIT_ASSERT(satisfiable(d)==satisfiable(e));
+    }
+    CPPUNIT_ASSERT_THROW(cnf2kcnf_factored(a,2),std::invalid_argument);
+  }
+
+void TestCnf2kcnf::test_incremental()
+  {
+    // batches on the same variables give the same output as the whole
+    // formula at once
+    cnf a {random_wide_cnf(50,300,12,7)};
+    for (auto strategy : {split_strategy::chain, split_strategy::tree}) {
+      cnf F {a.variables_number()};
+      cnf joined {};
+      kcnf_incremental T {3,strategy};
+      for (size_t i=0; i<a.size(); i+=37) {
+        for (size_t j=i; j<std::min(a.size(),i+37); ++j) F.add_clause(a[j]);
+        cnf delta {T.translate(F)};
+        CPPUNIT_ASSERT(F.watermark()==F.size());
+        CPPUNIT_ASSERT(delta.variables_number()==T.variables_number());
+        joined.append(delta);
+      }
+      CPPUNIT_ASSERT(joined==cnf2kcnf(a,3,strategy));
+      CPPUNIT_ASSERT(T.translate(F).size()==0);
+    }
+
+    // new variables are renamed after the extension variables
+    cnf b { {1,2,3,4,5} };
+    kcnf_incremental T {3};
+    cnf first {T.translate(b)};
+    CPPUNIT_ASSERT(first==cnf2kcnf(b,3));
+    b.add_clause({-7,1});
+    b.add_clause({7,-2,-3,-8});
+    cnf second {T.translate(b)};
+    variable y7 {T.output_variable(7)}, y8 {T.output_variable(8)};
+    CPPUNIT_ASSERT(y7==first.variables_number()+1);
+    CPPUNIT_ASSERT(y8>y7 && T.output_variable(6)==0 && T.output_variable(4)==4);
+    CPPUNIT_ASSERT(second[0]==clause_view({-y7,1}));
+    CPPUNIT_ASSERT(second.variables_number()==T.variables_number());
+
+    // equisatisfiable under every assignment of the original variables
+    for (int mask=0; mask<256; ++mask) {
+      cnf c {b};
+      cnf d {first};
+      d.append(second);
+      for (variable v=1; v<=8; ++v) {
+        c.add_clause({toliteral(v,(mask>>(v-1))&1)});
+        if (T.output_variable(v)!=0)
+          d.add_clause({toliteral(T.output_variable(v),(mask>>(v-1))&1)});
+      }
+      CPPUNIT_ASSERT(satisfiable(c)==satisfiable(d));
+    }
+
+    // the watermark follows the formula
+    cnf e {b};
+    CPPUNIT_ASSERT(e.watermark()==3 && e==b);
+    e.truncate(1);
+    CPPUNIT_ASSERT(e.watermark()==1);
+    e.set_watermark(0);
+    CPPUNIT_ASSERT(e.watermark()==0 && e.size()==1 && e[0]==b[0]);
+    CPPUNIT_ASSERT_THROW(kcnf_incremental(2),std::invalid_argument);
+  }
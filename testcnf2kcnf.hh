@@ -26,6 +26,11 @@ class TestCnf2kcnf : public CppUnit::TestFixture  {
   CPPUNIT_TEST( test_to3cnf);
   CPPUNIT_TEST( test_to4cnf);
   // CPPUNIT_TEST( test_to5cnf);
+  CPPUNIT_TEST( test_streaming );
+  CPPUNIT_TEST( test_parallel );
+  CPPUNIT_TEST( test_tree_split );
+  CPPUNIT_TEST( test_factoring );
+  CPPUNIT_TEST( test_incremental );
   CPPUNIT_TEST_SUITE_END();
  
 public:
@@ -37,6 +42,11 @@ public:
   virtual void test_to3cnf();
   virtual void test_to4cnf();
   // virtual void test_to5cnf();
+  virtual void test_streaming();
+  virtual void test_parallel();
+  virtual void test_tree_split();
+  virtual void test_factoring();
+  virtual void test_incremental();
 };
 
 #endif /* _TESTCNF2KCNF_HH_ */
@@ -13,10 +13,20 @@
 // Preamble
 //#include <cppunit/extensions/HelperMacros.h>
 
+#include <climits>
+#include <cstdlib>
+#include <fstream>
 #include <string>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
 
 #include "testparser.hh"
 #include "cnftools.hh"
+#include "dimacs_reader.hh"
+#include "mapped_file.hh"
 
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( TestDimacsParser, "Testing the dimacs parser" );
 
@@ -33,6 +43,22 @@ static bool parser_throws(const std::string& data) {
   return false;
 }
 
+// Outcome of a parse: the formula in dimacs format or the name of the
+// exception.
+static std::string parse_outcome(const std::string& data,unsigned int threads) {
+  std::ostringstream out;
+  try {
+    out<<parse_dimacs(data,threads);
+  } catch(dimacs_bad_syntax& e) {
+    return "bad syntax";
+  } catch(dimacs_truncated& e) {
+    return "truncated";
+  } catch(dimacs_bad_value& e) {
+    return "bad value";
+  }
+  return out.str();
+}
+
 void TestDimacsParser::setUp() {}
 void TestDimacsParser::tearDown() {}
 
@@ -77,3 +103,420 @@ void TestDimacsParser::read_clauses() {
 }
 
 
+void TestDimacsParser::read_literals() {
+  cnf a { {1,-2,3}, {-3}, {} };
+  CPPUNIT_ASSERT_MESSAGE("Spaces, tabs and newlines separate literals",
+                         parse_dimacs("p cnf 3 3\n1\t-2\n 3 0\r\n -3 0 0\n")==a);
+  CPPUNIT_ASSERT_MESSAGE("Explicit sign and leading zeros are allowed",
+                         parse_dimacs("p cnf 3 3\n+1 -0002 00000000000003 0 -3 -0 0")==a);
+  CPPUNIT_ASSERT_MESSAGE("Comments before spec line are ignored",
+                         parse_dimacs("c comment\n\n  \nc another\np cnf 3 3\n1 -2 3 0 -3 0 0")==a);
+  CPPUNIT_ASSERT_MESSAGE("Literals must be separated by spaces",
+                         parser_throws<dimacs_bad_syntax>("p  cnf 3 1\n 1-2 0"));
+  CPPUNIT_ASSERT_MESSAGE("A sign must be followed by digits",
+                         parser_throws<dimacs_bad_syntax>("p  cnf 3 1\n 1 - 2 0"));
+  CPPUNIT_ASSERT_MESSAGE("Literals must fit in an integer",
+                         parser_throws<dimacs_bad_syntax>("p  cnf 3 1\n 1 99999999999 0"));
+  CPPUNIT_ASSERT_MESSAGE("Missing spec line",
+                         parser_throws<dimacs_truncated>("c only a comment\n"));
+}
+
+
+void TestDimacsParser::read_buffered() {
+  std::string data {"c a formula with long literals\n"
+                    "p cnf 123456789 4\n"
+                    "1 -2 123456789 0\n"
+                    "-123456789   -00000000005 7 0 12345678 0\n"
+                    "-1 2 0\n"};
+
+  cnf a {parse_dimacs(data)};
+  CPPUNIT_ASSERT(a.size()==4);
+
+  // the stream is read in tiny blocks, so that tokens cross the
+  // boundaries of the buffer.
+  for (size_t size=1; size<12; ++size) {
+    std::istringstream in {data};
+    dimacs_reader reader {in,size};
+    CPPUNIT_ASSERT_MESSAGE("Buffered reader must not depend on block size",
+                           parse_dimacs(reader)==a);
+  }
+
+  // a token which ends exactly at the end of the input, followed by a
+  // missing clause
+  for (size_t size=1; size<12; ++size) {
+    std::istringstream in {"p cnf 3 3\n1 -2 0\n3 0"};
+    dimacs_reader reader {in,size};
+    CPPUNIT_ASSERT_THROW(parse_dimacs(reader),dimacs_truncated);
+  }
+}
+
+
+void TestDimacsParser::read_file() {
+  std::string data {"c formula in a file\np cnf 4 3\n1 -2 0\n-3 4 2 0\n0\n"};
+
+  char path[] = "/tmp/cnftools-test-XXXXXX";
+  int fd = mkstemp(path);
+  CPPUNIT_ASSERT(fd>=0);
+  close(fd);
+  std::ofstream {path} << data;
+
+  CPPUNIT_ASSERT_MESSAGE("Parsing a mapped file and a string must agree",
+                         parse_dimacs_file(path)==parse_dimacs(data));
+  unlink(path);
+
+  CPPUNIT_ASSERT_THROW(parse_dimacs_file(path),std::system_error);
+}
+
+
+void TestDimacsParser::read_parallel() {
+  std::vector<std::string> inputs {
+    "p cnf 5 6\n1 -2 0 3 4 5 -1 0\n0\n-5 -4 0 +2 -0 00003 -1 2 4 0\n",
+    "p cnf 5 4\n1 -2 0 3 4 5 -1 0\n0\n-5 -4 0 +2 -0 00003 -1 2 4 0 garbage",
+    "p cnf 5 3\n1 -2 0 3 4 5 -1 0\n0\n-5 -4 0 +2 -0 00003 -1 2 4 0 1 2",
+    "p cnf 5 7\n1 -2 0 3 4 5 -1 0\n0\n-5 -4 0 +2 -0 00003 -1 2 4 0\n",
+    "p cnf 5 7\n1 -2 0 3 4 5 -1 0\n0\n-5 -4 0 +2 -0 00003 -1 2 4 0 1 2",
+    "p cnf 5 6\n1 -2 0 3 4 x -1 0\n0\n-5 -4 0 +2 -0 00003 -1 2 4 0\n",
+    "p cnf 4 6\n1 -2 0 3 4 5 -1 0\n0\n-5 -4 0 +2 -0 00003 -1 2 4 0\n",
+    "p cnf 4 6\n1 -2 0 3 4 -1 0\n0\n-4 -4 0 +2 -0 00003 -1 2 4 0\n 7 0",
+    "p cnf 4 0\n",
+    "p cnf 4 0\n 1 2 x",
+    "p cnf 4 2\n 1 2 3 4 1 2 3 4 1 2 3 4 1 2 3 4 1 2 3 4 0 1 0"};
+
+  for(const auto& data : inputs) {
+    std::string expected {parse_outcome(data,1)};
+    for(unsigned int threads=2; threads<=16; ++threads)
+      CPPUNIT_ASSERT_MESSAGE("Parallel parser must agree with the sequential one",
+                             parse_outcome(data,threads)==expected);
+    // more threads than bytes, or than can be started
+    CPPUNIT_ASSERT(parse_outcome(data,UINT_MAX)==expected);
+  }
+}
+
+
+void TestDimacsParser::write_dimacs() {
+  cnf a { {1,-22,333}, {}, {-2147483647, 2147483647}, {-4444,55555,-666666,7777777} };
+  std::string expected {"p cnf 2147483647 4\n"
+                        "1 -22 333 0\n"
+                        " 0\n"
+                        "-2147483647 2147483647 0\n"
+                        "-4444 55555 -666666 7777777 0\n"};
+
+  std::ostringstream out;
+  out<<a;
+  CPPUNIT_ASSERT_MESSAGE("Dimacs output format",out.str()==expected);
+
+  // a tiny buffer is flushed many times
+  std::ostringstream small;
+  {
+    dimacs_writer writer {small,1};
+    writer.write(a);
+  }
+  CPPUNIT_ASSERT_MESSAGE("Output must not depend on buffer size",small.str()==expected);
+  CPPUNIT_ASSERT_MESSAGE("Output can be parsed back",parse_dimacs(small.str())==a);
+}
+
+
+void TestDimacsParser::binary_cache() {
+  std::vector<cnf> formulas {cnf{}, cnf{7}, cnf{{1,-2},{},{3,4,-5}},
+                             random_wide_cnf(100,1000,40,3)};
+
+  for (const auto& F : formulas) {
+    std::ostringstream out;
+    write_cnf_cache(out,F);
+    std::string data {out.str()};
+    const char* begin = data.data();
+    const char* end   = begin+data.size();
+
+    CPPUNIT_ASSERT(is_cnf_cache(begin,end));
+    CPPUNIT_ASSERT_MESSAGE("A formula must survive a binary cache",
+                           read_cnf_cache(begin,end)==F);
+
+    // any change is detected
+    CPPUNIT_ASSERT_THROW(read_cnf_cache(begin,end-1),cnf_cache_invalid);
+    for (size_t i=0; i<data.size(); i += (i<48 ? 1 : 7)) {
+      std::string corrupted {data};
+      corrupted[i] ^= 0x10;
+      CPPUNIT_ASSERT_THROW(read_cnf_cache(corrupted.data(),corrupted.data()+corrupted.size()),
+                           cnf_cache_invalid);
+    }
+  }
+
+  std::string text {"p cnf 3 1\n1 2 3 0\n"};
+  CPPUNIT_ASSERT(!is_cnf_cache(text.data(),text.data()+text.size()));
+  CPPUNIT_ASSERT_THROW(read_cnf_cache(text.data(),text.data()+text.size()),cnf_cache_invalid);
+
+  // the format of a file is detected from its content
+  char path[] = "/tmp/cnftools-test-XXXXXX";
+  int fd = mkstemp(path);
+  CPPUNIT_ASSERT(fd>=0);
+  close(fd);
+  cnf F {parse_dimacs(text)};
+  std::ofstream {path} << text;
+  CPPUNIT_ASSERT(load_cnf_file(path)==F);
+  {
+    std::ofstream out {path, std::ios::binary};
+    write_cnf_cache(out,F);
+  }
+  CPPUNIT_ASSERT(load_cnf_file(path)==F);
+  unlink(path);
+}
+
+
+void TestDimacsParser::compressed_files() {
+  CPPUNIT_ASSERT(compression_by_extension("a.cnf.gz")==compression::gzip);
+  CPPUNIT_ASSERT(compression_by_extension("a.cnf.xz")==compression::xz);
+  CPPUNIT_ASSERT(compression_by_extension("a.zst")==compression::zstd);
+  CPPUNIT_ASSERT(compression_by_extension("a.cnf")==compression::none);
+
+  char path[] = "/tmp/cnftools-test-XXXXXX";
+  int fd = mkstemp(path);
+  CPPUNIT_ASSERT(fd>=0);
+  close(fd);
+
+  // several blocks of decompressed data
+  cnf F {random_wide_cnf(1000,40000,50,5)};
+
+  for (const std::string extension : {".gz",".xz",".zst"}) {
+    std::string name {std::string{path}+extension};
+    auto format = compression_by_extension(name);
+
+    if (!compression_supported(format)) {
+      CPPUNIT_ASSERT_THROW(compressed_ofstream{name},compression_error);
+      continue;
+    }
+
+    {
+      compressed_ofstream out {name};
+      out<<F;
+      out.close();
+    }
+    std::string data;
+    {
+      mapped_file file {name};
+      data.assign(file.begin(),file.end());
+    }
+    CPPUNIT_ASSERT(compression_by_magic(data.data(),data.data()+data.size())==format);
+    CPPUNIT_ASSERT_MESSAGE("A compressed file must be parsed as the original one",
+                           parse_dimacs_file(name)==F);
+    CPPUNIT_ASSERT(load_cnf_file(name)==F);
+    {
+      std::ifstream in {name, std::ios::binary};
+      CPPUNIT_ASSERT(compression_by_magic(in)==format);
+      CPPUNIT_ASSERT(read_cnf(in)==F);
+    }
+
+    // binary caches can be compressed too
+    {
+      compressed_ofstream out {name};
+      write_cnf_cache(out,F);
+      out.close();
+    }
+    CPPUNIT_ASSERT(load_cnf_file(name)==F);
+
+    // gzip members one after the other, and padding after the last one
+    if (format==compression::gzip) {
+      std::ostringstream text;
+      text<<F;
+      std::string members;
+      for (const std::string& part : {text.str().substr(0,text.str().size()/2),
+                                     text.str().substr(text.str().size()/2)}) {
+        {
+          compressed_ofstream out {name};
+          out<<part;
+          out.close();
+        }
+        mapped_file file {name};
+        members.append(file.begin(),file.end());
+      }
+      for (const std::string& padding : {std::string{},std::string(1000,'\0'),
+                                        std::string{"\x1f garbage"}}) {
+        std::istringstream in {members+padding};
+        CPPUNIT_ASSERT(read_cnf(in)==F);
+      }
+    }
+
+    // broken files
+    for (size_t length : {data.size()/2, data.size()-1}) {
+      std::istringstream in {data.substr(0,length)};
+      CPPUNIT_ASSERT_THROW(read_cnf(in),compression_error);
+    }
+    data[data.size()/2] ^= 0x55;
+    data[data.size()/2+1] ^= 0x55;
+    std::istringstream in {data};
+    CPPUNIT_ASSERT_THROW(read_cnf(in),std::exception);
+
+    unlink(name.c_str());
+  }
+  unlink(path);
+}
+
+
+// Random dimacs text: clauses of literals with up to 10 digits, with
+// signs, leading zeros, all kinds of spaces, and sometimes a bad
+// character.
+static std::string random_dimacs(uint64_t seed,size_t clauses,bool errors) {
+  uint64_t state {seed};
+  auto next = [&state](uint64_t n) {
+    state = state*6364136223846793005ULL + 1442695040888963407ULL;
+    return (state >> 33) % n;
+  };
+  const std::string separators[] {" "," "," ","  ","\t","\n","\r\n","\v","\f"," \t "};
+  std::string text {"p cnf 2000000000 "+std::to_string(clauses)+"\n"};
+  for (size_t i=0; i<clauses; ++i) {
+    size_t width = next(12);
+    for (size_t j=0; j<=width; ++j) {
+      if (next(3)==0) text += (next(2) ? "-" : "+");
+      size_t digits = 1 + next(next(4)==0 ? 10 : 4);
+      if (j==width) digits = 1 + next(3);
+      for (size_t d=0; d<digits; ++d)
+        text += static_cast<char>('0' + (j==width ? 0 : (d==0 && next(4) ? 1+next(9) : next(10))));
+      if (errors && next(200)==0) text += "x";
+      text += separators[next(10)];
+    }
+  }
+  return text;
+}
+
+// Clauses read from a stream with a small buffer, so that many tokens
+// cross the end of the buffer.
+static std::string read_outcome(const std::string& data,size_t buffer_size) {
+  std::istringstream in {data};
+  std::ostringstream out;
+  dimacs_reader reader {in,buffer_size};
+  try {
+    variable n;
+    cnf::size_type m;
+    clause c;
+    reader.read_spec(n,m);
+    for (size_t i=0; i<m; ++i) {
+      reader.read_clause(c);
+      for (literal lit : c) out<<lit<<' ';
+      out<<"0\n";
+    }
+  } catch(dimacs_bad_syntax& e) {
+    return "bad syntax";
+  } catch(dimacs_truncated& e) {
+    return "truncated";
+  }
+  return out.str();
+}
+
+void TestDimacsParser::scanners() {
+  auto original = dimacs_active_scanner();
+  CPPUNIT_ASSERT(dimacs_scanner_supported(dimacs_scanner::scalar));
+
+  std::vector<std::string> inputs;
+  for (uint64_t seed=1; seed<=40; ++seed) {
+    std::string text {random_dimacs(seed,seed*10,seed%4==0)};
+    // also cut at every position near the end
+    inputs.push_back(text);
+    for (size_t cut=1; cut<40 && cut<text.size(); cut+=3)
+      inputs.push_back(text.substr(0,text.size()-cut));
+  }
+  std::ostringstream valid;
+  valid<<random_wide_cnf(5000000,500,60,3);
+  inputs.push_back(valid.str());
+
+  dimacs_set_scanner(dimacs_scanner::scalar);
+  std::vector<std::string> expected;
+  std::vector<std::string> streamed;
+  for (const auto& text : inputs) {
+    expected.push_back(parse_outcome(text,1));
+    streamed.push_back(read_outcome(text,37));
+  }
+  CPPUNIT_ASSERT(expected.back()==valid.str());
+
+  for (auto s : {dimacs_scanner::sse2, dimacs_scanner::avx2}) {
+    if (!dimacs_scanner_supported(s)) {
+      CPPUNIT_ASSERT_THROW(dimacs_set_scanner(s),std::invalid_argument);
+      continue;
+    }
+    dimacs_set_scanner(s);
+    for (size_t i=0; i<inputs.size(); ++i) {
+      CPPUNIT_ASSERT_MESSAGE("All scanners must give the same results",
+                             parse_outcome(inputs[i],1)==expected[i]);
+      CPPUNIT_ASSERT_MESSAGE("All scanners must give the same results",
+                             read_outcome(inputs[i],37)==streamed[i]);
+    }
+  }
+  dimacs_set_scanner(original);
+}
+
+
+// Outcome of the computation of the statistics of a dimacs text, in
+// the same form as `parse_outcome`.
+static std::string statistics_outcome(const std::string& data,unsigned int threads) {
+  std::ostringstream out;
+  try {
+    cnf_statistics s {dimacs_statistics(data.data(),data.data()+data.size(),threads)};
+    out<<s.variables<<" "<<s.clauses<<" "<<s.literals<<" |";
+    for (auto w : s.widths) out<<" "<<w;
+    out<<" |";
+    for (auto o : s.occurrences) out<<" "<<o;
+  } catch(dimacs_bad_syntax& e) {
+    return "bad syntax";
+  } catch(dimacs_truncated& e) {
+    return "truncated";
+  } catch(dimacs_bad_value& e) {
+    return "bad value";
+  }
+  return out.str();
+}
+
+void TestDimacsParser::statistics() {
+  cnf a {random_wide_cnf(300,2000,40,5)};
+  a.add_clause({});
+  a.add_clause({-7});
+  std::ostringstream out;
+  out<<a;
+  std::string text {out.str()};
+
+  cnf_statistics s {formula_statistics(a)};
+  CPPUNIT_ASSERT(s.clauses==a.size() && s.literals==a.literals_number());
+  CPPUNIT_ASSERT(s.widths[0]==1 && s.units()>=1 && s.max_width()<=40);
+  uint64_t sevens {0};
+  for (auto c : a)
+    for (auto lit : c) sevens += (lit==-7);
+  CPPUNIT_ASSERT(s.negative(7)==sevens);
+
+  // the same counts from the text, on any number of threads
+  std::string expected {statistics_outcome(text,1)};
+  for (unsigned int threads=2; threads<=8; ++threads)
+    CPPUNIT_ASSERT(statistics_outcome(text,threads)==expected);
+  CPPUNIT_ASSERT(statistics_outcome(text,UINT_MAX)==expected);
+  for (unsigned int threads=1; threads<=8; ++threads)
+    CPPUNIT_ASSERT(statistics_outcome(text+"%\n0\n\n",threads)==expected);
+  cnf_statistics t {dimacs_statistics(text.data(),text.data()+text.size(),3)};
+  CPPUNIT_ASSERT(t.widths==s.widths && t.occurrences==s.occurrences);
+
+  // the same errors as the parser, and the clauses after the m-th are
+  // ignored
+  const std::string inputs[] {
+    "p cnf 3 2\n1 2 0\n-3 0\n4 5 0\n",
+    "p cnf 3 2\n1 2 0\n-4 0\n",
+    "p cnf 3 3\n1 2 0\n-3 0\n",
+    "p cnf 3 2\n1 2 0\n-3 x 0\n",
+    "p cnf 3 2\n1 2 0\n-3 0\n1 x 0\n",
+    "p cnf 3 2\n1 2 0\n-3 0\n%\n0\n\n",
+    "p cnf 3 2\n1 2 0\n-3 0\n0\n0\n0\n",
+    "p cnf 3 4\n1 2 0\n-3 0\n1 x 0\n2 0\n"};
+  for (const auto& input : inputs) {
+    std::string outcome {statistics_outcome(input,1)};
+    std::string parsed  {parse_outcome(input,1)};
+    if (parsed=="bad syntax" || parsed=="truncated" || parsed=="bad value")
+      CPPUNIT_ASSERT(outcome==parsed);
+    else
+      CPPUNIT_ASSERT(outcome==statistics_outcome(parsed,1));
+    for (unsigned int threads=2; threads<=4; ++threads)
+      CPPUNIT_ASSERT(statistics_outcome(input,threads)==outcome);
+  }
+
+  // the predicted size of the output of cnf2kcnf
+  for (size_t k=3; k<6; ++k)
+    for (auto strategy : {split_strategy::chain, split_strategy::tree}) {
+      cnf b {cnf2kcnf(a,k,strategy)};
+      auto size = kcnf_output_size(s,k,strategy);
+      CPPUNIT_ASSERT(size.variables==b.variables_number());
+      CPPUNIT_ASSERT(size.clauses==b.size() && size.literals==b.literals_number());
+    }
+}
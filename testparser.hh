@@ -22,6 +22,15 @@ class TestDimacsParser : public CppUnit::TestFixture  {
   CPPUNIT_TEST_SUITE( TestDimacsParser );
   CPPUNIT_TEST( spec_line_parse );
   CPPUNIT_TEST( read_clauses );
+  CPPUNIT_TEST( read_literals );
+  CPPUNIT_TEST( read_buffered );
+  CPPUNIT_TEST( read_file );
+  CPPUNIT_TEST( read_parallel );
+  CPPUNIT_TEST( write_dimacs );
+  CPPUNIT_TEST( binary_cache );
+  CPPUNIT_TEST( compressed_files );
+  CPPUNIT_TEST( scanners );
+  CPPUNIT_TEST( statistics );
   CPPUNIT_TEST_SUITE_END();
  
 public:
@@ -29,6 +38,15 @@ public:
   virtual void tearDown();
   virtual void spec_line_parse();
   virtual void read_clauses();
+  virtual void read_literals();
+  virtual void read_buffered();
+  virtual void read_file();
+  virtual void read_parallel();
+  virtual void write_dimacs();
+  virtual void binary_cache();
+  virtual void compressed_files();
+  virtual void scanners();
+  virtual void statistics();
 };
 #endif /* _TESTPARSER_HH_ */
 